@@ -0,0 +1,59 @@
+#ifndef BSTK_ATOMIC_FILE_HPP
+#define BSTK_ATOMIC_FILE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace bstk {
+
+	// Crash-safe file replacement: content goes to a temporary file in the
+	// target's directory and is renamed over the target only once complete,
+	// so readers see either the old or the new file, never a truncated one
+	class AtomicFile {
+	public:
+		explicit AtomicFile(std::string target);
+		~AtomicFile(); // Removes the temporary file unless committed
+
+		AtomicFile(const AtomicFile&) = delete;
+		AtomicFile& operator=(const AtomicFile&) = delete;
+		AtomicFile(AtomicFile&& other) noexcept;
+		AtomicFile& operator=(AtomicFile&&) = delete;
+
+		// Create the temporary file
+		[[nodiscard]] bool open();
+		// Gathered write of all chunks (writev where available)
+		[[nodiscard]] bool write(const std::vector<std::string>& chunks);
+		// Start writeback without waiting, lets many files flush together
+		void start_sync() noexcept;
+		// Wait until the data is durable (fdatasync / FlushFileBuffers)
+		[[nodiscard]] bool sync();
+		// Close and rename over the target
+		[[nodiscard]] bool commit();
+		// Drop the temporary file
+		void discard() noexcept;
+
+		[[nodiscard]] const std::string& target() const noexcept { return target_; }
+		[[nodiscard]] const std::string& temp_path() const noexcept { return temp_; }
+
+		// Make completed renames in a directory durable (no-op on Windows)
+		static bool sync_directory(const std::string& directory);
+		[[nodiscard]] static std::string parent_directory(std::string_view path);
+
+	private:
+		std::string target_;
+		std::string temp_;
+#ifdef _WIN32
+		void* handle_ = nullptr;
+#else
+		int fd_ = -1;
+#endif
+		bool committed_ = false;
+
+		void close_handle() noexcept;
+	};
+
+} // namespace bstk
+
+#endif // BSTK_ATOMIC_FILE_HPP
\ No newline at end of file
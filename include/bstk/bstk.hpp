@@ -5,8 +5,15 @@
 #include "value.hpp"
 #include "parser.hpp"
 #include "config.hpp"
+#include "config_view.hpp"
+#include "config_cache.hpp"
+#include "config_set.hpp"
+#include "shared_config.hpp"
+#include "config_watcher.hpp"
+#include "stream_parser.hpp"
 #include "global.hpp"
 #include "instance.hpp"
 #include "instance_manager.hpp"
+#include "instance_table.hpp"
 
 #endif // BSTK_BSTK_HPP
\ No newline at end of file
@@ -3,39 +3,138 @@
 
 #include "value.hpp"
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <string>
 #include <string_view>
+#include <span>
 #include <fstream>
 #include <functional>
+#include <optional>
+#include <memory>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <utility>
 
 namespace bstk {
 
+	// Transparent hash so string_view keys probe the map without allocating
+	struct StringHash {
+		using is_transparent = void;
+		[[nodiscard]] size_t operator()(std::string_view sv) const noexcept { return std::hash<std::string_view>{}(sv); }
+		[[nodiscard]] size_t operator()(const std::string& s) const noexcept { return std::hash<std::string_view>{}(s); }
+		[[nodiscard]] size_t operator()(const char* s) const noexcept { return std::hash<std::string_view>{}(s); }
+	};
+
+	class ConfigView;
+
+	// Pre-resolved reference to one entry, skips hashing on access. Stays
+	// valid across rehashes and other inserts; goes stale (get returns
+	// nullptr, set returns false) once the key is removed or the Config reloads.
+	// Handles are not carried over when a Config is copied, and assigning
+	// over a Config makes the handles taken from it stale.
+	struct KeyHandle {
+		uint32_t slot = UINT32_MAX;
+		uint32_t generation = 0;
+
+		[[nodiscard]] bool valid() const noexcept { return slot != UINT32_MAX; }
+		bool operator==(const KeyHandle&) const = default;
+	};
+
+	// Key order used when serializing
+	enum class SerializeOrder {
+		Sorted,     // Alphabetical, blank line between top-level sections
+		Insertion   // Order keys were first loaded or set
+	};
+
+	// Threading: const lookups, iteration and prefix queries may run on
+	// several threads at once (the sorted index is rebuilt under a lock).
+	// Lazy values, serializing and saving update internal caches, and every
+	// non-const call needs exclusive access.
 	class Config {
 	public:
-		using Iterator = std::unordered_map<std::string, Value>::iterator;
-		using ConstIterator = std::unordered_map<std::string, Value>::const_iterator;
+		using Map = std::unordered_map<std::string, Value, StringHash, std::equal_to<>>;
+		using Iterator = Map::iterator;
+		using ConstIterator = Map::const_iterator;
+		using Entry = Map::value_type;
 
 		Config() = default;
+		Config(const Config& other);
+		Config(Config&&) noexcept = default;
+		Config& operator=(const Config& other);
+		Config& operator=(Config&& other) noexcept;
+
+		// Lazy mode keeps parsed values as raw text until first typed access
+		void set_lazy_values(bool enable) noexcept { lazy_values_ = enable; }
+		[[nodiscard]] bool lazy_values() const noexcept { return lazy_values_; }
 
 		// Load from file
 		[[nodiscard]] bool load_from_file(const std::string& filepath);
 		[[nodiscard]] bool load_from_string(std::string_view content);
 
+		// Parse newline-aligned chunks on separate threads (0 = hardware concurrency),
+		// duplicate keys resolve last-writer-wins exactly like load_from_file
+		[[nodiscard]] bool load_from_file_parallel(const std::string& filepath, unsigned threads = 0);
+		[[nodiscard]] bool load_from_string_parallel(std::string_view content, unsigned threads = 0);
+
+		// Load through a binary cache (filepath + ".cache" by default), which is
+		// rebuilt whenever the hash of the text no longer matches; see config_cache.hpp
+		[[nodiscard]] bool load_cached(const std::string& filepath, const std::string& cache_path = {});
+
+		// Re-read and apply only the differences: unchanged entries (and handles
+		// to them) are kept, changed keys (added, modified or removed) are
+		// appended to changed. Leaves the Config clean, like a full load.
+		[[nodiscard]] bool reload_from_file(const std::string& filepath, std::vector<std::string>& changed);
+		[[nodiscard]] bool reload_from_string(std::string_view content, std::vector<std::string>& changed);
+
 		// Save to file
-		[[nodiscard]] bool save_to_file(const std::string& filepath) const;
-		[[nodiscard]] std::string to_string() const;
+		[[nodiscard]] bool save_to_file(const std::string& filepath, SerializeOrder order = SerializeOrder::Sorted) const;
+		[[nodiscard]] std::string to_string(SerializeOrder order = SerializeOrder::Sorted) const;
+
+		// Crash-safe save: temp file in the same directory, optionally flushed
+		// to disk, then renamed over the target
+		[[nodiscard]] bool save_atomic(const std::string& filepath, bool durable = true,
+			SerializeOrder order = SerializeOrder::Sorted) const;
+
+		// Atomic save of many configs with the disk flushes issued as one batch,
+		// returns the number of files written
+		struct SaveTarget {
+			const Config* config;
+			std::string filepath;
+		};
+		[[nodiscard]] static size_t save_all_atomic(const std::vector<SaveTarget>& targets, bool durable = true,
+			SerializeOrder order = SerializeOrder::Sorted);
+
+		// Rewrite only the lines of an existing file whose keys changed since the
+		// last load/save, copying everything else verbatim; new keys are appended.
+		// The result replaces the file atomically and, when durable, is flushed
+		// to disk before the rename, like save_atomic.
+		[[nodiscard]] bool save_patch(const std::string& filepath, bool durable = true);
+
+		// Keys set to a different value or removed since the last load/save
+		[[nodiscard]] bool is_dirty() const noexcept { return !dirty_.empty(); }
+		[[nodiscard]] std::vector<std::string> dirty_keys() const;
+		void mark_clean() noexcept { dirty_.clear(); }
 
 		// Value access
 		[[nodiscard]] bool has(std::string_view key) const;
 		[[nodiscard]] const Value* get(std::string_view key) const;
 		[[nodiscard]] Value* get(std::string_view key);
 
+		// Handle access, resolve returns an invalid handle for a missing key
+		[[nodiscard]] KeyHandle resolve(std::string_view key);
+		[[nodiscard]] const Value* get(KeyHandle handle) const;
+		[[nodiscard]] Value* get(KeyHandle handle);
+		bool set(KeyHandle handle, const Value& value);
+		bool set(KeyHandle handle, Value&& value);
+
 		// Template getters with defaults
 		template<typename T>
 		[[nodiscard]] T get_or(std::string_view key, T default_val) const;
 
-		// Setters
+		// Setters. The value is always stored as given; one with the same text
+		// as before (e.g. Int 1 over a parsed "1") is not marked dirty or notified.
 		void set(std::string_view key, const Value& value);
 		void set(std::string_view key, Value&& value);
 		void set_string(std::string_view key, std::string_view value);
@@ -46,6 +145,19 @@ namespace bstk {
 		// Remove
 		bool remove(std::string_view key);
 
+		// Batched editing. Changes apply immediately but are logged so they
+		// can be undone; the sorted index is rebuilt and notifications are
+		// delivered once the outermost batch commits. A nested begin_batch()
+		// is a savepoint: commit() folds it into the enclosing batch and
+		// rollback() undoes only the changes made since it. Loads, reloads
+		// and assignments inside a batch drop everything logged so far: the
+		// batch stays open, but rollback() only undoes changes made after
+		// them. Handles to removed keys stay stale.
+		void begin_batch();
+		bool commit();   // false if no batch is open
+		bool rollback(); // false if no batch is open
+		[[nodiscard]] bool in_batch() const noexcept { return !savepoints_.empty(); }
+
 		// Iteration
 		[[nodiscard]] ConstIterator begin() const noexcept { return data_.begin(); }
 		[[nodiscard]] ConstIterator end() const noexcept { return data_.end(); }
@@ -55,51 +167,198 @@ namespace bstk {
 		// Queries
 		[[nodiscard]] size_t size() const noexcept { return data_.size(); }
 		[[nodiscard]] bool empty() const noexcept { return data_.empty(); }
-		void clear() noexcept { data_.clear(); modified_keys_.clear(); }
+		void clear() noexcept;
 
-		// Hierarchical access (e.g., "bst.instance.Pie64.ram")
+		// Hierarchical access (e.g., "bst.instance.Pie64.ram"), O(log n + matches)
 		[[nodiscard]] std::vector<std::string> get_keys_with_prefix(std::string_view prefix) const;
 		[[nodiscard]] Config get_namespace(std::string_view prefix) const;
 
 		// Instance management helpers (BlueStacks specific)
+		static constexpr std::string_view instance_prefix = "bst.instance.";
+		// Names in first-seen order, kept up to date by set/remove/load
 		[[nodiscard]] std::vector<std::string> get_instance_names() const;
+		[[nodiscard]] size_t instance_count() const noexcept { return instance_names_.size(); }
+		// "Pie64" for "bst.instance.Pie64.ram", empty optional for other keys
+		[[nodiscard]] static std::optional<std::string_view> instance_name_of(std::string_view key) noexcept;
 		[[nodiscard]] Config get_instance_config(std::string_view instance_name) const;
 
+		// Non-owning prefix-scoped windows, see config_view.hpp
+		[[nodiscard]] ConfigView view(std::string_view prefix) const;
+		[[nodiscard]] ConfigView instance_view(std::string_view instance_name) const;
+
+		// Change notifications. A pattern ending in '.' (e.g. "bst.instance.Pie64.")
+		// matches every key below it, "" matches all keys, anything else one key.
+		// Fired by set/remove and reload_from_*, not by full loads. Subscriptions
+		// stay with their object: copies start without any, and copy or move
+		// assignment onto a Config keeps its own subscribers.
+		using SubscriptionId = uint64_t;
+		using ChangeCallback = std::function<void(const std::vector<std::string>& keys)>;
+		SubscriptionId subscribe(std::string_view pattern, ChangeCallback callback);
+		bool unsubscribe(SubscriptionId id);
+
+		// Holds notifications back until the outermost batch ends, then each
+		// subscriber is called once with all of its changed keys. Delivery runs
+		// in the destructor, so exceptions thrown by callbacks there are dropped
+		// (every other subscriber is still notified).
+		class NotificationBatch {
+		public:
+			explicit NotificationBatch(Config& config) : config_(config) { ++config_.batch_depth_; }
+			~NotificationBatch() {
+				if (--config_.batch_depth_ == 0) config_.deliver_notifications(/*contain_errors=*/true);
+			}
+
+			NotificationBatch(const NotificationBatch&) = delete;
+			NotificationBatch& operator=(const NotificationBatch&) = delete;
+
+		private:
+			Config& config_;
+		};
+
+		// Scoped begin_batch(). commit() keeps the changes; leaving the scope
+		// without it (an early return or an exception) rolls them back, and
+		// exceptions thrown by callbacks during that rollback are dropped.
+		class Batch {
+		public:
+			explicit Batch(Config& config) : config_(&config) { config.begin_batch(); }
+			~Batch() {
+				if (config_) config_->rollback_batch(/*contain_errors=*/true);
+			}
+
+			bool commit() {
+				if (!config_) return false;
+				return std::exchange(config_, nullptr)->commit();
+			}
+
+			Batch(const Batch&) = delete;
+			Batch& operator=(const Batch&) = delete;
+
+		private:
+			Config* config_;
+		};
+
 	private:
-		std::unordered_map<std::string, Value> data_;
-		std::vector<std::string> modified_keys_; // Track order for serialization
+		friend class ConfigStreamParser;
+		friend class ConfigView;
+		friend class ConfigCache;
+
+		Map data_;
+		std::vector<const Entry*> order_; // Insertion order, nodes are pointer-stable
+
+		// Key-ordered index for prefix queries. Built lazily; the lock lets
+		// concurrent const readers share one rebuild. Not copied, copies
+		// rebuild it against their own nodes.
+		struct SortedIndex {
+			std::vector<const Entry*> entries;
+			std::atomic<bool> valid{ false };
+			std::mutex mutex;
+
+			SortedIndex() = default;
+			SortedIndex(SortedIndex&& other) noexcept
+				: entries(std::move(other.entries)), valid(other.valid.exchange(false, std::memory_order_relaxed)) {}
+			SortedIndex& operator=(SortedIndex&& other) noexcept {
+				entries = std::move(other.entries);
+				valid.store(other.valid.exchange(false, std::memory_order_relaxed), std::memory_order_relaxed);
+				return *this;
+			}
+			void invalidate() noexcept { valid.store(false, std::memory_order_relaxed); }
+		};
+		mutable SortedIndex sorted_;
+		mutable size_t size_hint_ = 0;    // Last serialized size, reserves the next one
+		std::vector<std::string> instance_names_;
+		std::unordered_map<std::string, size_t, StringHash, std::equal_to<>> instance_key_counts_;
+		mutable std::unordered_set<std::string, StringHash, std::equal_to<>> dirty_;
+		bool lazy_values_ = false;
+
+		struct HandleSlot {
+			Entry* entry = nullptr;
+			uint32_t generation = 0;
+		};
+		std::vector<HandleSlot> handle_slots_;
+		std::vector<uint32_t> free_handle_slots_;
+		std::unordered_map<const Entry*, uint32_t> handle_slot_of_;
+
+		struct Subscriptions {
+			struct Subscription {
+				std::string pattern;
+				ChangeCallback callback;
+			};
+			std::unordered_map<SubscriptionId, Subscription> by_id;
+			std::unordered_map<std::string, std::vector<SubscriptionId>, StringHash, std::equal_to<>> by_pattern;
+			SubscriptionId next_id = 1;
+			std::vector<std::string> pending; // Changed keys not yet delivered
+			std::unordered_set<std::string, StringHash, std::equal_to<>> pending_set;
+		};
+		std::unique_ptr<Subscriptions> subscriptions_; // Allocated on first subscribe
+		unsigned batch_depth_ = 0;
+
+		// Prior state of a key changed inside a batch
+		struct UndoRecord {
+			std::string key;
+			std::optional<Value> previous; // Empty if the key did not exist
+			size_t order_index;            // Insertion-order slot of a removed key
+			bool was_dirty;
+			bool was_pending;              // Already queued for notification
+		};
+		std::vector<UndoRecord> undo_log_;
+		std::vector<size_t> savepoints_;   // undo_log_ size at each begin_batch
+
+		void on_insert(const Entry& entry);
+		void on_erase(const Entry& entry);
+		void mark_dirty(std::string_view key);
+		void notify_change(std::string_view key);
+		void deliver_notifications(bool contain_errors = false);
+		void log_undo(std::string_view key, const Value* previous, size_t order_index = 0);
+		void undo(UndoRecord& record);
+		bool rollback_batch(bool contain_errors);
+		void end_batch(bool contain_errors = false);
+		void assign(Entry& entry, Value&& value);
+		void release_handle(const Entry& entry);
+		void invalidate_handles() noexcept;
+		void drop_undo_log() noexcept;
+		[[nodiscard]] Entry* entry_of(KeyHandle handle) const noexcept;
+		void register_instance_key(std::string_view key);
+		void unregister_instance_key(std::string_view key);
+		static void append_entry(std::string& out, const Entry& entry);
+
+		// Key order for the sorted index. Also compares entries against a key
+		// given as head + tail, so prefix bounds need no joined std::string.
+		struct KeyLess {
+			struct Split {
+				std::string_view head;
+				std::string_view tail;
+			};
+
+			bool operator()(const Entry* a, const Entry* b) const noexcept { return a->first < b->first; }
+			bool operator()(const Entry* a, const Split& key) const noexcept { return compare(a->first, key) < 0; }
+
+			[[nodiscard]] static int compare(std::string_view key, const Split& split) noexcept {
+				int c = key.substr(0, split.head.size()).compare(split.head);
+				return c != 0 ? c : key.substr(split.head.size()).compare(split.tail);
+			}
+			[[nodiscard]] static bool starts_with(std::string_view key, const Split& split) noexcept {
+				return key.starts_with(split.head) && key.substr(split.head.size()).starts_with(split.tail);
+			}
+		};
+
+		[[nodiscard]] const std::vector<const Entry*>& sorted_entries() const;
+		// Entries whose key starts with prefix + tail, in key order
+		[[nodiscard]] std::span<const Entry* const> prefix_range(std::string_view prefix, std::string_view tail = {}) const;
+		[[nodiscard]] std::vector<std::string> serialize_chunks(SerializeOrder order, size_t chunk_size) const;
 
 		void parse_content(std::string_view content);
+		void parse_content_parallel(std::string_view content, unsigned threads);
+		void insert_parsed(std::string_view key, Value&& value);
+		void insert_parsed(std::string&& key, Value&& value);
+		[[nodiscard]] Value make_parsed_value(std::string_view raw_value) const;
+		[[nodiscard]] static size_t estimate_line_count(std::string_view content);
 	};
 
 	// Template implementations
 	template<typename T>
 	T Config::get_or(std::string_view key, T default_val) const {
-		auto it = data_.find(std::string(key));
+		auto it = data_.find(key);
 		if (it == data_.end()) return default_val;
-
-		if constexpr (std::is_same_v<T, std::string>) {
-			return it->second.as_string();
-		}
-		else if constexpr (std::is_same_v<T, int64_t>) {
-			return it->second.as_int();
-		}
-		else if constexpr (std::is_same_v<T, int>) {
-			return static_cast<int>(it->second.as_int());
-		}
-		else if constexpr (std::is_same_v<T, double>) {
-			return it->second.as_double();
-		}
-		else if constexpr (std::is_same_v<T, float>) {
-			return static_cast<float>(it->second.as_double());
-		}
-		else if constexpr (std::is_same_v<T, bool>) {
-			return it->second.as_bool();
-		}
-		else {
-			static_assert(std::is_same_v<T, T>, "Unsupported type for get_or");
-			return default_val;
-		}
+		return it->second.as<T>();
 	}
 
 } // namespace bstk
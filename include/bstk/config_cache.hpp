@@ -0,0 +1,68 @@
+#ifndef BSTK_CONFIG_CACHE_HPP
+#define BSTK_CONFIG_CACHE_HPP
+
+#include "config.hpp"
+#include "mapped_file.hpp"
+#include <string>
+#include <string_view>
+#include <optional>
+#include <cstdint>
+
+namespace bstk {
+
+	// Binary snapshot of a parsed Config, used through a read-only MappedFile.
+	// Layout: header (with a hash of the source text), key-sorted record
+	// table with typed values, insertion order, then one string pool.
+	// Lookups binary-search the mapped table; nothing is parsed on open.
+	// Native byte order, a cache from another architecture is rejected.
+	class ConfigCache {
+	public:
+		ConfigCache() = default;
+
+		// Serialize config (built from source) to path, replacing it atomically
+		static bool write(const Config& config, std::string_view source, const std::string& path);
+
+		// Map and validate a cache file, false if missing or malformed
+		[[nodiscard]] bool open(const std::string& path);
+		void close() noexcept;
+		[[nodiscard]] bool is_open() const noexcept { return header_ != nullptr; }
+
+		// True if the cache was built from exactly this text
+		[[nodiscard]] bool matches(std::string_view source) const;
+
+		[[nodiscard]] size_t size() const noexcept;
+		[[nodiscard]] bool has(std::string_view key) const { return find(key) != nullptr; }
+		[[nodiscard]] std::optional<Value> get(std::string_view key) const;
+
+		template<typename T>
+		[[nodiscard]] T get_or(std::string_view key, T default_val) const {
+			auto val = get(key);
+			return val ? val->as<T>() : default_val;
+		}
+
+		// Replace config's content with the cached entries, in insertion order.
+		// The key-sorted table also becomes config's sorted index.
+		void load_into(Config& config) const;
+
+		// Stable 64-bit hash of source text (not std::hash, which may change between builds)
+		[[nodiscard]] static uint64_t hash(std::string_view content) noexcept;
+
+	private:
+		struct Header;
+		struct Record;
+
+		MappedFile file_;
+		const Header* header_ = nullptr;
+		const Record* records_ = nullptr;
+		const uint32_t* order_ = nullptr;
+		const char* pool_ = nullptr;
+
+		[[nodiscard]] static size_t records_offset() noexcept;
+		[[nodiscard]] const Record* find(std::string_view key) const;
+		[[nodiscard]] std::string_view key_of(const Record& record) const noexcept;
+		[[nodiscard]] Value value_of(const Record& record) const;
+	};
+
+} // namespace bstk
+
+#endif // BSTK_CONFIG_CACHE_HPP
\ No newline at end of file
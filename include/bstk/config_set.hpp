@@ -0,0 +1,68 @@
+#ifndef BSTK_CONFIG_SET_HPP
+#define BSTK_CONFIG_SET_HPP
+
+#include "config.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <functional>
+
+namespace bstk {
+
+	// Many independent config files (e.g. one bluestacks.conf per host),
+	// loaded concurrently and queried together. Key patterns used by the
+	// queries may contain '*' to match one key segment: "bst.instance.*.ram".
+	class ConfigSet {
+	public:
+		struct Member {
+			std::string path;
+			Config config;
+			bool loaded = false;
+			std::string error;                     // Why loading failed
+			std::chrono::microseconds load_time{ 0 };
+		};
+
+		struct LoadStats {
+			size_t loaded = 0;
+			size_t failed = 0;
+			std::chrono::milliseconds wall_time{ 0 };
+			std::string error;                     // Path and reason if enumeration stopped early
+		};
+
+		using MatchCallback = std::function<void(const Member& member, std::string_view key, const Value& value)>;
+
+		// Replace the set with these files, loaded on a work-stealing pool
+		// (0 threads = hardware concurrency)
+		LoadStats load(const std::vector<std::string>& paths, unsigned threads = 0);
+		// Every file called filename below root. A traversal error stops the
+		// walk; the files found so far are loaded and stats.error says where.
+		LoadStats load_directory(const std::string& root, std::string_view filename = "bluestacks.conf", unsigned threads = 0);
+
+		// Members in path order, failed loads included
+		[[nodiscard]] const std::vector<Member>& members() const noexcept { return members_; }
+		[[nodiscard]] size_t size() const noexcept { return members_.size(); }
+		[[nodiscard]] const Member* find(std::string_view path) const;
+		[[nodiscard]] std::vector<const Member*> failed() const;
+
+		// Visit every key matching pattern in every loaded member
+		void for_each_match(std::string_view pattern, const MatchCallback& fn) const;
+
+		// How often each value occurs for the matching keys, by value text
+		[[nodiscard]] std::map<std::string, size_t> distribution(std::string_view pattern) const;
+
+		// Members where any matching key has this value text / satisfies pred
+		[[nodiscard]] std::vector<const Member*> where(std::string_view pattern, std::string_view value) const;
+		[[nodiscard]] std::vector<const Member*> where(std::string_view pattern, const std::function<bool(const Value&)>& pred) const;
+
+		// '*' matches one segment (any run of characters without '.')
+		[[nodiscard]] static bool matches(std::string_view key, std::string_view pattern) noexcept;
+
+	private:
+		std::vector<Member> members_;
+	};
+
+} // namespace bstk
+
+#endif // BSTK_CONFIG_SET_HPP
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef BSTK_CONFIG_VIEW_HPP
+#define BSTK_CONFIG_VIEW_HPP
+
+#include "config.hpp"
+#include <string>
+#include <string_view>
+#include <iterator>
+#include <cstddef>
+
+namespace bstk {
+
+	// Non-owning, prefix-scoped window onto a Config. Keys are addressed
+	// without the prefix ("ram" for "bst.instance.Pie64.ram") and nothing is
+	// copied. Iterators are invalidated by inserting or removing keys in the
+	// parent; the view itself stays usable as long as the parent lives.
+	class ConfigView {
+	public:
+		struct Item {
+			std::string_view key; // Key without the prefix
+			const Value& value;
+		};
+
+		class Iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = Item;
+			using difference_type = std::ptrdiff_t;
+			using pointer = void;
+			using reference = Item;
+
+			Iterator() = default;
+			Iterator(const Config::Entry* const* it, size_t prefix_size) : it_(it), prefix_size_(prefix_size) {}
+
+			[[nodiscard]] Item operator*() const {
+				return { std::string_view((*it_)->first).substr(prefix_size_), (*it_)->second };
+			}
+			Iterator& operator++() { ++it_; return *this; }
+			Iterator operator++(int) { auto tmp = *this; ++it_; return tmp; }
+			bool operator==(const Iterator& other) const { return it_ == other.it_; }
+
+		private:
+			const Config::Entry* const* it_ = nullptr;
+			size_t prefix_size_ = 0;
+		};
+
+		// A '.' is appended to prefixes that do not end with one
+		ConfigView(const Config& parent, std::string_view prefix);
+
+		[[nodiscard]] const std::string& prefix() const noexcept { return prefix_; }
+		[[nodiscard]] const Config& parent() const noexcept { return *parent_; }
+
+		// Value access relative to the prefix
+		[[nodiscard]] const Value* get(std::string_view key) const;
+		[[nodiscard]] bool has(std::string_view key) const { return get(key) != nullptr; }
+
+		template<typename T>
+		[[nodiscard]] T get_or(std::string_view key, T default_val) const {
+			const Value* val = get(key);
+			return val ? val->as<T>() : default_val;
+		}
+
+		// Iteration in key order, O(log n) to start
+		[[nodiscard]] Iterator begin() const;
+		[[nodiscard]] Iterator end() const;
+		[[nodiscard]] size_t size() const;
+		[[nodiscard]] bool empty() const { return begin() == end(); }
+
+		// Narrow further, e.g. view("bst").view("instance")
+		[[nodiscard]] ConfigView view(std::string_view sub_prefix) const;
+
+		// Materialize into an owning Config (same as Config::get_namespace)
+		[[nodiscard]] Config to_config() const;
+
+	private:
+		const Config* parent_;
+		std::string prefix_;
+
+		[[nodiscard]] std::span<const Config::Entry* const> range() const;
+	};
+
+} // namespace bstk
+
+#endif // BSTK_CONFIG_VIEW_HPP
\ No newline at end of file
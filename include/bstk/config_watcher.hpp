@@ -0,0 +1,73 @@
+#ifndef BSTK_CONFIG_WATCHER_HPP
+#define BSTK_CONFIG_WATCHER_HPP
+
+#include "config.hpp"
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+namespace bstk {
+
+	// Follows external rewrites of a config file and applies them to a live
+	// Config. Change events (inotify on Linux, change notifications on
+	// Windows) are collected without blocking; once the file has been quiet
+	// for the debounce interval it is re-read and only the keys that differ
+	// are applied. A rewrite with identical content is skipped before parsing.
+	// Not thread-safe: call poll()/wait() from the thread that owns the Config.
+	class ConfigWatcher {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		ConfigWatcher(Config& config, std::string filepath,
+			std::chrono::milliseconds debounce = std::chrono::milliseconds(200));
+		~ConfigWatcher();
+
+		ConfigWatcher(const ConfigWatcher&) = delete;
+		ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+		// Begin watching, the Config is assumed to match the file at this point
+		[[nodiscard]] bool start();
+		void stop() noexcept;
+		[[nodiscard]] bool is_watching() const noexcept;
+
+		// Collect pending events and reload if the debounce interval has
+		// passed, returns the changed keys (empty when nothing was applied)
+		std::vector<std::string> poll();
+
+		// Like poll(), but first waits up to timeout for a change event
+		std::vector<std::string> wait(std::chrono::milliseconds timeout);
+
+		// Reload right away, ignoring events and debounce
+		std::vector<std::string> reload();
+
+		[[nodiscard]] const std::string& filepath() const noexcept { return filepath_; }
+		[[nodiscard]] uint64_t reload_count() const noexcept { return reload_count_; }
+
+	private:
+		Config& config_;
+		std::string filepath_;
+		std::string filename_;
+		std::chrono::milliseconds debounce_;
+
+		bool pending_ = false;        // Events seen but not yet applied
+		Clock::time_point last_event_;
+		size_t content_hash_ = 0;     // Hash of the content last applied
+		bool has_hash_ = false;
+		uint64_t reload_count_ = 0;
+
+#ifdef _WIN32
+		void* handle_ = nullptr;
+#else
+		int fd_ = -1;
+#endif
+
+		// Non-blocking, true if any event concerned the watched file
+		bool drain_events();
+		// Block until an event arrives or the timeout expires
+		void wait_for_event(std::chrono::milliseconds timeout);
+	};
+
+} // namespace bstk
+
+#endif // BSTK_CONFIG_WATCHER_HPP
\ No newline at end of file
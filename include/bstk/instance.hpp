@@ -132,8 +132,6 @@ namespace bstk {
         Properties props_;
 
         [[nodiscard]] std::string full_key(std::string_view key) const;
-        void load_value(std::string_view key, auto& target);
-        void save_value(std::string_view key, const auto& source);
     };
 
     // Stream output
@@ -2,39 +2,123 @@
 #define BSTK_INSTANCE_MANAGER_HPP
 
 #include "instance.hpp"
+#include "config.hpp"
 #include <vector>
+#include <deque>
+#include <optional>
+#include <unordered_map>
 #include <iterator>
 #include <functional>
+#include <ranges>
+#include <concepts>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
 
 namespace bstk {
 
+	// Generation-checked reference to a managed instance; a handle to a
+	// removed instance resolves to nullptr instead of dangling
+	struct InstanceHandle {
+		uint32_t slot = UINT32_MAX;
+		uint32_t generation = 0;
+
+		[[nodiscard]] bool valid() const noexcept { return slot != UINT32_MAX; }
+		bool operator==(const InstanceHandle&) const = default;
+	};
+
+	// Iterator over the live instances (dereferences the stored pointers)
+	template<typename T>
+	class InstanceIterator {
+		using Base = std::vector<Instance*>::const_iterator;
+
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = Instance;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T*;
+		using reference = T&;
+
+		InstanceIterator() = default;
+		explicit InstanceIterator(Base it) : it_(it) {}
+		// Mutable to const conversion
+		template<typename U, typename = std::enable_if_t<std::is_const_v<T> && !std::is_const_v<U>>>
+		InstanceIterator(const InstanceIterator<U>& other) : it_(other.base()) {}
+
+		[[nodiscard]] reference operator*() const { return **it_; }
+		[[nodiscard]] pointer operator->() const { return *it_; }
+		[[nodiscard]] reference operator[](difference_type n) const { return *it_[n]; }
+
+		InstanceIterator& operator++() { ++it_; return *this; }
+		InstanceIterator operator++(int) { auto tmp = *this; ++it_; return tmp; }
+		InstanceIterator& operator--() { --it_; return *this; }
+		InstanceIterator operator--(int) { auto tmp = *this; --it_; return tmp; }
+		InstanceIterator& operator+=(difference_type n) { it_ += n; return *this; }
+		InstanceIterator& operator-=(difference_type n) { it_ -= n; return *this; }
+		[[nodiscard]] friend InstanceIterator operator+(InstanceIterator it, difference_type n) { return it += n; }
+		[[nodiscard]] friend InstanceIterator operator+(difference_type n, InstanceIterator it) { return it += n; }
+		[[nodiscard]] friend InstanceIterator operator-(InstanceIterator it, difference_type n) { return it -= n; }
+		[[nodiscard]] friend difference_type operator-(const InstanceIterator& a, const InstanceIterator& b) { return a.it_ - b.it_; }
+
+		bool operator==(const InstanceIterator& other) const { return it_ == other.it_; }
+		auto operator<=>(const InstanceIterator& other) const { return it_ <=> other.it_; }
+
+		[[nodiscard]] Base base() const { return it_; }
+
+	private:
+		Base it_{};
+	};
+
 	class InstanceManager {
 	public:
-		using Iterator = std::vector<Instance>::iterator;
-		using ConstIterator = std::vector<Instance>::const_iterator;
+		using Iterator = InstanceIterator<Instance>;
+		using ConstIterator = InstanceIterator<const Instance>;
 
 		explicit InstanceManager(Config& config);
+		InstanceManager(const InstanceManager& other);
+		InstanceManager(InstanceManager&&) noexcept = default;
+		InstanceManager& operator=(const InstanceManager& other);
+		InstanceManager& operator=(InstanceManager&&) noexcept = default;
 
 		// Load all instances from config
 		void reload();
 
 		// Instance access
-		[[nodiscard]] size_t count() const noexcept { return instances_.size(); }
-		[[nodiscard]] bool empty() const noexcept { return instances_.empty(); }
+		[[nodiscard]] size_t count() const noexcept { return order_.size(); }
+		[[nodiscard]] bool empty() const noexcept { return order_.empty(); }
 
 		// Get by index
-		[[nodiscard]] Instance& operator[](size_t index) { return instances_[index]; }
-		[[nodiscard]] const Instance& operator[](size_t index) const { return instances_[index]; }
+		[[nodiscard]] Instance& operator[](size_t index) { return *order_[index]; }
+		[[nodiscard]] const Instance& operator[](size_t index) const { return *order_[index]; }
 
-		// Get by name
+		// Get by name, O(1)
 		[[nodiscard]] Instance* get(std::string_view name);
 		[[nodiscard]] const Instance* get(std::string_view name) const;
 
-		// Find by predicate
-		[[nodiscard]] Instance* find(std::function<bool(const Instance&)> pred);
-		[[nodiscard]] std::vector<Instance*> find_all(std::function<bool(const Instance&)> pred);
-
-		// Create new instance
+		// Stable handles, valid until the instance is removed or reloaded
+		[[nodiscard]] InstanceHandle handle_of(std::string_view name) const;
+		[[nodiscard]] Instance* get(InstanceHandle handle);
+		[[nodiscard]] const Instance* get(InstanceHandle handle) const;
+
+		// Find by predicate, inlined at the call site (no std::function)
+		template<typename Pred> requires std::predicate<Pred&, const Instance&>
+		[[nodiscard]] Instance* find(Pred&& pred) {
+			for (Instance* inst : order_) {
+				if (pred(std::as_const(*inst))) return inst;
+			}
+			return nullptr;
+		}
+
+		template<typename Pred> requires std::predicate<Pred&, const Instance&>
+		[[nodiscard]] std::vector<Instance*> find_all(Pred&& pred) {
+			std::vector<Instance*> result;
+			for (Instance* inst : order_) {
+				if (pred(std::as_const(*inst))) result.push_back(inst);
+			}
+			return result;
+		}
+
+		// Create new instance; references to existing instances stay valid
 		Instance& create(std::string name);
 
 		// Remove instance
@@ -45,10 +129,16 @@ namespace bstk {
 		[[nodiscard]] bool has(std::string_view name) const;
 
 		// Iteration
-		[[nodiscard]] Iterator begin() { return instances_.begin(); }
-		[[nodiscard]] Iterator end() { return instances_.end(); }
-		[[nodiscard]] ConstIterator begin() const { return instances_.begin(); }
-		[[nodiscard]] ConstIterator end() const { return instances_.end(); }
+		[[nodiscard]] Iterator begin() { return Iterator(order_.cbegin()); }
+		[[nodiscard]] Iterator end() { return Iterator(order_.cend()); }
+		[[nodiscard]] ConstIterator begin() const { return ConstIterator(order_.cbegin()); }
+		[[nodiscard]] ConstIterator end() const { return ConstIterator(order_.cend()); }
+
+		// Lazy range over the instances, composes with the where_* adaptors
+		// below and std::views without building intermediate vectors:
+		// mgr.view() | where_high_fps() | where_ram_at_least(4096)
+		[[nodiscard]] std::ranges::subrange<Iterator> view() { return { begin(), end() }; }
+		[[nodiscard]] std::ranges::subrange<ConstIterator> view() const { return { begin(), end() }; }
 
 		// Bulk operations
 		void save_all();  // Save all instances to config
@@ -64,8 +154,20 @@ namespace bstk {
 		[[nodiscard]] const Config& config() const noexcept { return *config_; }
 
 	private:
+		// Slots never move (deque growth keeps element addresses), freed
+		// slots are reused with a bumped generation
+		struct Slot {
+			std::optional<Instance> instance;
+			uint32_t generation = 0;
+		};
+
 		Config* config_;
-		std::vector<Instance> instances_;
+		std::deque<Slot> slots_;
+		std::vector<uint32_t> free_slots_;
+		std::vector<Instance*> order_; // Live instances in creation order
+		std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> index_;
+
+		void release_all();
 	};
 
 	// Range-based for loop helper
@@ -74,6 +176,28 @@ namespace bstk {
 	inline InstanceManager::ConstIterator begin(const InstanceManager& mgr) { return mgr.begin(); }
 	inline InstanceManager::ConstIterator end(const InstanceManager& mgr) { return mgr.end(); }
 
+	// Filter adaptors for InstanceManager::view()
+	template<typename Pred>
+	[[nodiscard]] auto where(Pred pred) { return std::views::filter(std::move(pred)); }
+
+	[[nodiscard]] inline auto where_root_access() {
+		return where([](const Instance& inst) { return inst.props().enable_root_access; });
+	}
+	[[nodiscard]] inline auto where_high_fps() {
+		return where([](const Instance& inst) { return inst.props().enable_high_fps; });
+	}
+	[[nodiscard]] inline auto where_ram_at_least(int ram_mb) {
+		return where([ram_mb](const Instance& inst) { return inst.props().ram >= ram_mb; });
+	}
+	[[nodiscard]] inline auto where_cpus_at_least(int cpus) {
+		return where([cpus](const Instance& inst) { return inst.props().cpus >= cpus; });
+	}
+	[[nodiscard]] inline auto where_resolution(int width, int height) {
+		return where([width, height](const Instance& inst) {
+			return inst.props().fb_width == width && inst.props().fb_height == height;
+		});
+	}
+
 } // namespace bstk
 
 #endif // BSTK_INSTANCE_MANAGER_HPP
\ No newline at end of file
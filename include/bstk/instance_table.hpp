@@ -0,0 +1,79 @@
+#ifndef BSTK_INSTANCE_TABLE_HPP
+#define BSTK_INSTANCE_TABLE_HPP
+
+#include "instance_manager.hpp"
+#include <string>
+#include <vector>
+#include <span>
+#include <cstdint>
+
+namespace bstk {
+
+	// Column-oriented copy of the numeric and bool instance properties. Each
+	// int property is one contiguous array and each bool one bitset, so a
+	// filter touches only the columns it reads. Scans compare 64 rows into a
+	// word mask at a time (auto-vectorizable) and return row index lists.
+	// A snapshot: rebuild after the instances change. Rows can be appended
+	// from several managers to aggregate across hosts.
+	class InstanceTable {
+	public:
+		using Index = uint32_t;
+		using IndexList = std::vector<Index>;
+
+		enum class Column : uint8_t { FbWidth, FbHeight, Dpi, MaxFps, Cpus, Ram, AdbPort, Count };
+		enum class Flag : uint8_t {
+			HighFps, Vsync, FullscreenAllApps, FpsDisplay, RootAccess, Notifications,
+			GameControls, Sidebar, PinToTop, AirplaneMode, VulkanSupported, SoundWhileTapping, Count
+		};
+
+		InstanceTable() = default;
+		explicit InstanceTable(const InstanceManager& mgr) { append(mgr); }
+
+		void append(const InstanceManager& mgr);
+		void append(const Instance& instance);
+		void clear() noexcept;
+		void reserve(size_t rows);
+
+		[[nodiscard]] size_t size() const noexcept { return names_.size(); }
+		[[nodiscard]] bool empty() const noexcept { return names_.empty(); }
+		[[nodiscard]] const std::string& name(Index row) const { return names_[row]; }
+
+		// Raw column access
+		[[nodiscard]] std::span<const int32_t> column(Column c) const noexcept { return columns_[static_cast<size_t>(c)]; }
+		[[nodiscard]] bool flag(Flag f, Index row) const noexcept {
+			return (flags_[static_cast<size_t>(f)][row / 64] >> (row % 64)) & 1;
+		}
+
+		// Filters, rows in table order
+		[[nodiscard]] IndexList with_flag(Flag f) const;
+		[[nodiscard]] IndexList with_root_access() const { return with_flag(Flag::RootAccess); }
+		[[nodiscard]] IndexList with_high_fps() const { return with_flag(Flag::HighFps); }
+		[[nodiscard]] IndexList where_equal(Column c, int32_t value) const;
+		[[nodiscard]] IndexList where_at_least(Column c, int32_t value) const;
+		[[nodiscard]] IndexList where_between(Column c, int32_t low, int32_t high) const; // Inclusive
+		[[nodiscard]] IndexList matching_resolution(int32_t width, int32_t height) const;
+
+		// Both lists must be sorted (all filters return sorted lists)
+		[[nodiscard]] static IndexList intersect(const IndexList& a, const IndexList& b);
+
+		// Aggregates over all rows or a row list
+		[[nodiscard]] int64_t sum(Column c) const;
+		[[nodiscard]] int64_t sum(Column c, const IndexList& rows) const;
+		[[nodiscard]] size_t count(Flag f) const;
+
+	private:
+		// Bit i of word i / 64 is row i
+		using Bitset = std::vector<uint64_t>;
+
+		std::vector<std::string> names_;
+		std::vector<int32_t> columns_[static_cast<size_t>(Column::Count)];
+		Bitset flags_[static_cast<size_t>(Flag::Count)];
+
+		template<typename Pred>
+		[[nodiscard]] Bitset scan(Column c, Pred pred) const;
+		[[nodiscard]] static IndexList to_indices(const Bitset& mask);
+	};
+
+} // namespace bstk
+
+#endif // BSTK_INSTANCE_TABLE_HPP
\ No newline at end of file
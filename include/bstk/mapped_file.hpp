@@ -0,0 +1,62 @@
+#ifndef BSTK_MAPPED_FILE_HPP
+#define BSTK_MAPPED_FILE_HPP
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstddef>
+#include <system_error>
+
+namespace bstk {
+
+	// Read-only memory mapping of a whole file (RAII). Regular files are
+	// mapped at the size fstat reports when opened. Truncating a mapped file
+	// from another process makes reads past the new end fault (SIGBUS on
+	// POSIX, Windows refuses the truncation), so writers should replace
+	// files by rename as AtomicFile does. Pipes, procfs entries and other
+	// files that cannot be mapped are read into an owned buffer instead.
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		explicit MappedFile(const std::string& filepath) { open(filepath); }
+		~MappedFile() { close(); }
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		// Map or read the file, returns false if it cannot be opened or read
+		// and leaves the reason in error()
+		bool open(const std::string& filepath);
+		void close() noexcept;
+
+		// An empty file is open but has no data
+		[[nodiscard]] bool is_open() const noexcept { return open_; }
+		[[nodiscard]] const char* data() const noexcept { return data_; }
+		[[nodiscard]] size_t size() const noexcept { return size_; }
+		[[nodiscard]] std::string_view view() const noexcept { return { data_, size_ }; }
+		// Why the last open() failed, cleared by the next open() or close()
+		[[nodiscard]] const std::error_code& error() const noexcept { return error_; }
+
+	private:
+		const char* data_ = nullptr;
+		size_t size_ = 0;
+		bool open_ = false;
+		std::unique_ptr<char[]> buffer_; // Contents when not mapped
+		size_t capacity_ = 0;
+		std::error_code error_;
+
+		// Double the buffer without zero-filling, keeping the first used bytes
+		void grow_buffer(size_t used);
+		// Close and record the OS error code, returns false
+		bool fail(int code) noexcept;
+#ifdef _WIN32
+		void* file_ = nullptr;
+		void* mapping_ = nullptr;
+#endif
+	};
+
+} // namespace bstk
+
+#endif // BSTK_MAPPED_FILE_HPP
\ No newline at end of file
@@ -14,11 +14,23 @@ namespace bstk {
 		bool is_valid = false;
 	};
 
+	// Trimmed key and raw (still quoted/escaped) value of a line
+	struct LineSpan {
+		std::string_view key;
+		std::string_view value;
+	};
+
 	class Parser {
 	public:
 		// Parse a single line, returns empty optional if line is empty/comment
 		[[nodiscard]] static std::optional<ParsedLine> parse_line(std::string_view line);
 
+		// Split a line without copying, returns empty optional if line is empty/comment
+		[[nodiscard]] static std::optional<LineSpan> split_line(std::string_view line);
+
+		// Unquote, unescape and infer the type of a raw value
+		[[nodiscard]] static class Value parse_value(std::string_view raw_value);
+
 		// Unescape a quoted string value
 		[[nodiscard]] static std::string unescape(std::string_view value);
 
@@ -28,8 +40,18 @@ namespace bstk {
 		// Infer type and create appropriate Value
 		[[nodiscard]] static class Value infer_value(std::string_view raw_value);
 
-	private:
+		// ASCII whitespace, independent of the global locale
+		[[nodiscard]] static constexpr bool is_space(char c) noexcept {
+			return c == ' ' || (c >= '\t' && c <= '\r');
+		}
 		[[nodiscard]] static std::string_view trim(std::string_view sv);
+
+		// Whole-text decimal double (optional sign), false instead of throwing
+		// when it is malformed or out of range
+		[[nodiscard]] static bool parse_double(std::string_view text, double& out) noexcept;
+
+	private:
+		[[nodiscard]] static std::string unquote(std::string_view value_view);
 		[[nodiscard]] static bool looks_like_int(std::string_view sv);
 		[[nodiscard]] static bool looks_like_double(std::string_view sv);
 		[[nodiscard]] static bool looks_like_bool(std::string_view sv);
@@ -0,0 +1,140 @@
+#ifndef BSTK_SHARED_CONFIG_HPP
+#define BSTK_SHARED_CONFIG_HPP
+
+#include "config.hpp"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+namespace bstk {
+
+	// Immutable version of a SharedConfig. Keys are spread over fixed hash
+	// shards; a snapshot only references its shards, so versions that differ
+	// in one key share every other shard. Reading a snapshot never locks.
+	class ConfigSnapshot {
+	public:
+		static constexpr size_t shard_count = 64;
+
+		ConfigSnapshot();
+
+		[[nodiscard]] const Value* get(std::string_view key) const;
+		[[nodiscard]] bool has(std::string_view key) const { return get(key) != nullptr; }
+
+		template<typename T>
+		[[nodiscard]] T get_or(std::string_view key, T default_val) const {
+			const Value* val = get(key);
+			return val ? val->as<T>() : default_val;
+		}
+
+		[[nodiscard]] size_t size() const noexcept { return size_; }
+		[[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+		// Increases by one with every published change
+		[[nodiscard]] uint64_t version() const noexcept { return version_; }
+
+		// Visit every entry, in no particular order
+		void for_each(const std::function<void(const std::string&, const Value&)>& fn) const;
+
+		// Copy into a regular (clean) Config, e.g. for saving
+		[[nodiscard]] Config to_config() const;
+
+	private:
+		friend class SharedConfig;
+		using Shard = std::shared_ptr<const Config::Map>;
+
+		std::array<Shard, shard_count> shards_;
+		size_t size_ = 0;
+		uint64_t version_ = 0;
+
+		[[nodiscard]] static size_t shard_of(std::string_view key) noexcept {
+			return StringHash{}(key) % shard_count;
+		}
+	};
+
+	// Config shared between one writer and many reader threads. Readers take
+	// a snapshot and query it without locks; writers build the next version
+	// by copying only the shards they touch and publish it atomically.
+	// Writers are serialized among themselves and do their editing without
+	// blocking readers. Taking a snapshot is only as lock-free as
+	// std::atomic<std::shared_ptr> (libstdc++ guards it with a short internal
+	// lock); hot read paths should go through a Reader, which only reloads
+	// when the version changed.
+	class SharedConfig {
+	public:
+		// Collects edits for one published version
+		class Editor {
+		public:
+			void set(std::string_view key, Value value);
+			bool remove(std::string_view key);
+			[[nodiscard]] const Value* get(std::string_view key) const;
+
+		private:
+			friend class SharedConfig;
+			explicit Editor(ConfigSnapshot& next) : next_(next) {}
+
+			ConfigSnapshot& next_;
+			std::array<bool, ConfigSnapshot::shard_count> copied_{};
+			bool changed_ = false;
+
+			// Private copy of a shard, made on first write to it
+			Config::Map& writable(size_t shard);
+		};
+
+		SharedConfig();
+		explicit SharedConfig(const Config& config);
+
+		SharedConfig(const SharedConfig&) = delete;
+		SharedConfig& operator=(const SharedConfig&) = delete;
+
+		// Current version; keep the pointer to read a consistent state
+		[[nodiscard]] std::shared_ptr<const ConfigSnapshot> snapshot() const noexcept {
+			return current_.load(std::memory_order_acquire);
+		}
+
+		// Version of the latest published snapshot, a plain atomic load
+		[[nodiscard]] uint64_t version() const noexcept {
+			return version_.load(std::memory_order_acquire);
+		}
+
+		// Per-thread cached snapshot. current() compares the cached version
+		// with version() and only takes a new snapshot when they differ, so
+		// an unchanged config is read without touching the shared pointer.
+		// A Reader must not be shared between threads.
+		class Reader {
+		public:
+			explicit Reader(const SharedConfig& shared) : shared_(shared), cached_(shared.snapshot()) {}
+
+			[[nodiscard]] const ConfigSnapshot& current() {
+				if (cached_->version() != shared_.version()) cached_ = shared_.snapshot();
+				return *cached_;
+			}
+
+		private:
+			const SharedConfig& shared_;
+			std::shared_ptr<const ConfigSnapshot> cached_;
+		};
+
+		// Apply several edits as one version, returns false if nothing changed
+		bool update(const std::function<void(Editor&)>& edit);
+
+		// Single-edit shortcuts
+		void set(std::string_view key, Value value);
+		bool remove(std::string_view key);
+
+		// Replace the whole content
+		void assign(const Config& config);
+
+	private:
+		std::atomic<std::shared_ptr<const ConfigSnapshot>> current_;
+		std::atomic<uint64_t> version_{ 0 }; // Stored after current_, see Reader
+		std::mutex write_mutex_;
+	};
+
+} // namespace bstk
+
+#endif // BSTK_SHARED_CONFIG_HPP
\ No newline at end of file
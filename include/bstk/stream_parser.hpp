@@ -0,0 +1,54 @@
+#ifndef BSTK_STREAM_PARSER_HPP
+#define BSTK_STREAM_PARSER_HPP
+
+#include "value.hpp"
+#include <string>
+#include <string_view>
+#include <functional>
+#include <istream>
+
+namespace bstk {
+
+	class Config;
+
+	// Incremental parser for configs arriving in arbitrary byte chunks
+	// (pipes, sockets, decompressors). Only a partial trailing line is
+	// buffered between calls.
+	class ConfigStreamParser {
+	public:
+		using Callback = std::function<void(std::string_view key, Value&& value)>;
+
+		// Emit every parsed entry to a callback
+		explicit ConfigStreamParser(Callback on_entry);
+		// Insert entries into a Config as they arrive (honours its lazy mode).
+		// This is a load: entries are not marked dirty, notified or logged
+		// for undo, so save_patch() leaves out keys streamed into an already
+		// populated Config. Use the callback and Config::set() for edits.
+		explicit ConfigStreamParser(Config& target);
+
+		// Feed the next chunk, complete lines are parsed immediately
+		void feed(std::string_view chunk);
+		// Read an input stream to EOF in fixed-size chunks
+		bool feed(std::istream& in, size_t chunk_size = 64 * 1024);
+		// Flush the final line if the input did not end with a newline
+		void finish();
+
+		// Lazy values for the callback mode
+		void set_lazy_values(bool enable) noexcept { lazy_values_ = enable; }
+
+		[[nodiscard]] size_t entries() const noexcept { return entries_; }
+		[[nodiscard]] size_t buffered() const noexcept { return carry_.size(); }
+
+	private:
+		Callback callback_;
+		Config* target_ = nullptr;
+		std::string carry_; // Partial line split across chunks
+		size_t entries_ = 0;
+		bool lazy_values_ = false;
+
+		void parse_lines(std::string_view lines);
+	};
+
+} // namespace bstk
+
+#endif // BSTK_STREAM_PARSER_HPP
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef BSTK_TOKENIZER_HPP
+#define BSTK_TOKENIZER_HPP
+
+#include "parser.hpp"
+#include <string_view>
+#include <cstdint>
+
+namespace bstk {
+
+	// Splits a whole document into key/value spans in one forward pass.
+	// Newlines and '=' are located 64 bytes at a time with the widest
+	// SIMD kernel the CPU supports (AVX2, SSE2 or scalar, picked at runtime).
+	class Tokenizer {
+	public:
+		// Classifier kernels; Auto is the widest supported one. Forcing a
+		// specific kernel is meant for tests and benchmarks.
+		enum class Kernel { Auto, Scalar, Sse2, Avx2 };
+
+		explicit Tokenizer(std::string_view content, Kernel kernel = Kernel::Auto) noexcept;
+
+		// Advance to the next key/value line, returns false at end of input
+		[[nodiscard]] bool next(LineSpan& out);
+
+		// Name of the kernel selected for this CPU
+		[[nodiscard]] static const char* kernel_name() noexcept;
+		// Whether this build and CPU can run the kernel (Auto always can)
+		[[nodiscard]] static bool supported(Kernel kernel) noexcept;
+
+	private:
+		uint64_t (*classify_)(const char* block); // Bit i set for '\n' or '=' at block[i]
+		const char* end_;
+		const char* next_block_;   // Next 64-byte block to classify
+		const char* block_;        // Block the masks refer to
+		uint64_t mask_ = 0;        // Pending '\n' and '=' positions in block_
+		const char* line_start_;
+		const char* eq_ = nullptr; // First '=' of the current line
+
+		void load_block();
+	};
+
+} // namespace bstk
+
+#endif // BSTK_TOKENIZER_HPP
\ No newline at end of file
@@ -2,27 +2,52 @@
 #define BSTK_VALUE_HPP
 
 #include <string>
+#include <string_view>
 #include <variant>
 #include <stdexcept>
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
 
 namespace bstk {
 
+	// Tagged 16-byte cell. Numbers and bools live in the first word, strings
+	// up to 14 chars are stored inline, longer ones in an exact-size heap block.
 	class Value {
 	public:
 		using Variant = std::variant<std::string, int64_t, double, bool>;
 
-		Value() = default;
-		explicit Value(std::string val) : data_(std::move(val)) {}
-		explicit Value(int64_t val) : data_(val) {}
-		explicit Value(double val) : data_(val) {}
-		explicit Value(bool val) : data_(val) {}
+		Value() noexcept { set_inline({}); }
+		explicit Value(std::string_view val) { set_string(val); }
+		explicit Value(const std::string& val) { set_string(val); }
+		explicit Value(int64_t val) noexcept { set_word(Kind::Int, val); }
+		explicit Value(double val) noexcept { set_word(Kind::Double, val); }
+		explicit Value(bool val) noexcept { set_word(Kind::Bool, val); }
+
+		Value(const Value& other);
+		Value(Value&& other) noexcept;
+		Value& operator=(const Value& other);
+		Value& operator=(Value&& other) noexcept;
+		~Value() { release(); }
+
+		// Deferred value holding raw config text (still quoted/escaped);
+		// type inference and unescaping run on first typed access
+		[[nodiscard]] static Value lazy(std::string_view raw_text) {
+			Value v(raw_text);
+			v.cell_[flags_byte] |= pending_flag;
+			return v;
+		}
+
+		// Run pending inference now (e.g. before sharing across threads)
+		void resolve() const { if (is_pending()) resolve_pending(); }
+		[[nodiscard]] bool is_pending() const noexcept { return (cell_[flags_byte] & pending_flag) != 0; }
 
 		// Type checks
-		[[nodiscard]] bool is_string() const noexcept { return std::holds_alternative<std::string>(data_); }
-		[[nodiscard]] bool is_int() const noexcept { return std::holds_alternative<int64_t>(data_); }
-		[[nodiscard]] bool is_double() const noexcept { return std::holds_alternative<double>(data_); }
-		[[nodiscard]] bool is_bool() const noexcept { return std::holds_alternative<bool>(data_); }
-		[[nodiscard]] bool is_number() const noexcept { return is_int() || is_double(); }
+		[[nodiscard]] bool is_string() const { resolve(); return kind() == Kind::String; }
+		[[nodiscard]] bool is_int() const { resolve(); return kind() == Kind::Int; }
+		[[nodiscard]] bool is_double() const { resolve(); return kind() == Kind::Double; }
+		[[nodiscard]] bool is_bool() const { resolve(); return kind() == Kind::Bool; }
+		[[nodiscard]] bool is_number() const { return is_int() || is_double(); }
 
 		// Getters with automatic conversion attempts
 		[[nodiscard]] std::string as_string() const;
@@ -30,21 +55,99 @@ namespace bstk {
 		[[nodiscard]] double as_double() const;
 		[[nodiscard]] bool as_bool() const;
 
-		// Raw access
-		[[nodiscard]] const Variant& raw() const noexcept { return data_; }
-		[[nodiscard]] Variant& raw() noexcept { return data_; }
+		// View of a string value without copying, empty for other types
+		[[nodiscard]] std::string_view as_string_view() const;
+
+		// Typed getter: std::string, int64_t, int, double, float or bool
+		template<typename T>
+		[[nodiscard]] T as() const;
+
+		// Copy unpacked into a variant; the packed cell holds no variant to reference
+		[[nodiscard]] Variant to_variant() const;
 
 		// Comparison
-		bool operator==(const Value& other) const { return data_ == other.data_; }
+		bool operator==(const Value& other) const;
 		bool operator!=(const Value& other) const { return !(*this == other); }
 
+		// Same serialized text across kinds, e.g. Int 1 and a parsed "1" (Bool).
+		// Numbers are formatted on the stack, nothing is allocated.
+		[[nodiscard]] bool same_text(const Value& other) const;
+
 		// String representation for serialization
 		[[nodiscard]] std::string to_string() const;
 
+		// Append the serialized form to out, no temporary strings
+		void append_to(std::string& out) const;
+
 	private:
-		Variant data_;
+		enum class Kind : uint8_t { String, Int, Double, Bool };
+
+		// Byte layout: [0, 8) number / bool / heap pointer, [8, 12) heap length,
+		// [0, 14) inline chars, 14 inline length, 15 kind and flags
+		static constexpr size_t inline_capacity = 14;
+		static constexpr size_t length_byte = 14;
+		static constexpr size_t flags_byte = 15;
+		static constexpr unsigned char kind_mask = 0x03;
+		static constexpr unsigned char heap_flag = 0x04;
+		static constexpr unsigned char pending_flag = 0x08;
+
+		// Lazy values are resolved in place from const accessors
+		alignas(8) mutable unsigned char cell_[16];
+
+		[[nodiscard]] Kind kind() const noexcept { return static_cast<Kind>(cell_[flags_byte] & kind_mask); }
+		[[nodiscard]] bool on_heap() const noexcept { return (cell_[flags_byte] & heap_flag) != 0; }
+		[[nodiscard]] std::string_view chars() const noexcept;
+		// Unescaped text; numbers are formatted into buf (number_chars long)
+		[[nodiscard]] std::string_view text(char* buf) const;
+
+		template<typename T>
+		[[nodiscard]] T word() const noexcept {
+			T val;
+			std::memcpy(&val, cell_, sizeof(T));
+			return val;
+		}
+
+		template<typename T>
+		void set_word(Kind kind, T val) noexcept {
+			std::memset(cell_, 0, sizeof(cell_));
+			std::memcpy(cell_, &val, sizeof(T));
+			cell_[flags_byte] = static_cast<unsigned char>(kind);
+		}
+
+		void set_inline(std::string_view val) noexcept;
+		void set_string(std::string_view val);
+		void release() const noexcept;
+		void resolve_pending() const;
 	};
 
+	static_assert(sizeof(Value) == 16, "Value must stay a 16-byte cell");
+
+	// Template implementations
+	template<typename T>
+	T Value::as() const {
+		if constexpr (std::is_same_v<T, std::string>) {
+			return as_string();
+		}
+		else if constexpr (std::is_same_v<T, int64_t>) {
+			return as_int();
+		}
+		else if constexpr (std::is_same_v<T, int>) {
+			return static_cast<int>(as_int());
+		}
+		else if constexpr (std::is_same_v<T, double>) {
+			return as_double();
+		}
+		else if constexpr (std::is_same_v<T, float>) {
+			return static_cast<float>(as_double());
+		}
+		else if constexpr (std::is_same_v<T, bool>) {
+			return as_bool();
+		}
+		else {
+			static_assert(sizeof(T) == 0, "Unsupported type for Value::as");
+		}
+	}
+
 } // namespace bstk
 
 #endif // BSTK_VALUE_HPP
\ No newline at end of file
@@ -0,0 +1,222 @@
+#include "bstk/atomic_file.hpp"
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace bstk {
+
+	namespace {
+
+		std::atomic<uint32_t> temp_counter{ 0 };
+
+		std::string make_temp_path(const std::string& target) {
+#ifdef _WIN32
+			unsigned long pid = GetCurrentProcessId();
+#else
+			unsigned long pid = static_cast<unsigned long>(::getpid());
+#endif
+			return target + "." + std::to_string(pid) + "." + std::to_string(temp_counter++) + ".tmp";
+		}
+
+	} // namespace
+
+	AtomicFile::AtomicFile(std::string target)
+		: target_(std::move(target)) {
+	}
+
+	AtomicFile::AtomicFile(AtomicFile&& other) noexcept
+		: target_(std::move(other.target_)),
+		temp_(std::move(other.temp_)),
+#ifdef _WIN32
+		handle_(std::exchange(other.handle_, nullptr)),
+#else
+		fd_(std::exchange(other.fd_, -1)),
+#endif
+		committed_(std::exchange(other.committed_, true)) {
+	}
+
+	AtomicFile::~AtomicFile() {
+		if (!committed_) discard();
+	}
+
+	std::string AtomicFile::parent_directory(std::string_view path) {
+		size_t slash = path.find_last_of("/\\");
+		if (slash == std::string_view::npos) return ".";
+		if (slash == 0) return std::string(path.substr(0, 1));
+		return std::string(path.substr(0, slash));
+	}
+
+#ifdef _WIN32
+
+	bool AtomicFile::open() {
+		temp_ = make_temp_path(target_);
+		HANDLE handle = CreateFileA(temp_.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (handle == INVALID_HANDLE_VALUE) return false;
+		handle_ = handle;
+		return true;
+	}
+
+	bool AtomicFile::write(const std::vector<std::string>& chunks) {
+		if (!handle_) return false;
+		for (const auto& chunk : chunks) {
+			const char* p = chunk.data();
+			size_t left = chunk.size();
+			while (left > 0) {
+				DWORD part = static_cast<DWORD>(left > 0x40000000 ? 0x40000000 : left);
+				DWORD written = 0;
+				if (!WriteFile(handle_, p, part, &written, nullptr)) return false;
+				p += written;
+				left -= written;
+			}
+		}
+		return true;
+	}
+
+	void AtomicFile::start_sync() noexcept {
+		// Windows has no asynchronous writeback hint
+	}
+
+	bool AtomicFile::sync() {
+		return handle_ && FlushFileBuffers(handle_);
+	}
+
+	bool AtomicFile::commit() {
+		if (!handle_) return false;
+		close_handle();
+		if (!MoveFileExA(temp_.c_str(), target_.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+			discard();
+			return false;
+		}
+		committed_ = true;
+		return true;
+	}
+
+	void AtomicFile::discard() noexcept {
+		close_handle();
+		if (!temp_.empty() && !committed_) DeleteFileA(temp_.c_str());
+		temp_.clear();
+	}
+
+	void AtomicFile::close_handle() noexcept {
+		if (handle_) CloseHandle(handle_);
+		handle_ = nullptr;
+	}
+
+	bool AtomicFile::sync_directory(const std::string&) {
+		return true;
+	}
+
+#else
+
+	bool AtomicFile::open() {
+		temp_ = make_temp_path(target_);
+
+		// Keep the target's permissions when replacing it
+		mode_t mode = 0644;
+		struct stat st {};
+		if (::stat(target_.c_str(), &st) == 0) mode = st.st_mode & 07777;
+
+		fd_ = ::open(temp_.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, mode);
+		return fd_ >= 0;
+	}
+
+	bool AtomicFile::write(const std::vector<std::string>& chunks) {
+		if (fd_ < 0) return false;
+
+		std::vector<iovec> iov;
+		iov.reserve(chunks.size());
+		for (const auto& chunk : chunks) {
+			if (!chunk.empty()) iov.push_back({ const_cast<char*>(chunk.data()), chunk.size() });
+		}
+
+		size_t next = 0;
+		while (next < iov.size()) {
+			int count = static_cast<int>(std::min<size_t>(iov.size() - next, IOV_MAX));
+			ssize_t written = ::writev(fd_, iov.data() + next, count);
+			if (written < 0) {
+				if (errno == EINTR) continue;
+				return false;
+			}
+
+			// Skip fully written buffers, trim a partially written one
+			size_t done = static_cast<size_t>(written);
+			while (next < iov.size() && done >= iov[next].iov_len) {
+				done -= iov[next].iov_len;
+				++next;
+			}
+			if (done > 0) {
+				iov[next].iov_base = static_cast<char*>(iov[next].iov_base) + done;
+				iov[next].iov_len -= done;
+			}
+		}
+		return true;
+	}
+
+	void AtomicFile::start_sync() noexcept {
+#ifdef __linux__
+		if (fd_ >= 0) ::sync_file_range(fd_, 0, 0, SYNC_FILE_RANGE_WRITE);
+#endif
+	}
+
+	bool AtomicFile::sync() {
+		if (fd_ < 0) return false;
+#if defined(__APPLE__)
+		return ::fsync(fd_) == 0;
+#else
+		return ::fdatasync(fd_) == 0;
+#endif
+	}
+
+	bool AtomicFile::commit() {
+		if (fd_ < 0) return false;
+		bool closed = ::close(fd_) == 0;
+		fd_ = -1;
+		if (!closed || std::rename(temp_.c_str(), target_.c_str()) != 0) {
+			discard();
+			return false;
+		}
+		committed_ = true;
+		return true;
+	}
+
+	void AtomicFile::discard() noexcept {
+		close_handle();
+		if (!temp_.empty() && !committed_) ::unlink(temp_.c_str());
+		temp_.clear();
+	}
+
+	void AtomicFile::close_handle() noexcept {
+		if (fd_ >= 0) ::close(fd_);
+		fd_ = -1;
+	}
+
+	bool AtomicFile::sync_directory(const std::string& directory) {
+		int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (fd < 0) return false;
+		bool ok = ::fsync(fd) == 0;
+		::close(fd);
+		return ok;
+	}
+
+#endif
+
+} // namespace bstk
\ No newline at end of file
@@ -1,17 +1,62 @@
 #include "bstk/config.hpp"
 #include "bstk/parser.hpp"
-#include <sstream>
+#include "bstk/mapped_file.hpp"
+#include "bstk/atomic_file.hpp"
+#include "bstk/tokenizer.hpp"
 #include <algorithm>
+#include <thread>
+#include <exception>
+#include <system_error>
+#include <utility>
 
 namespace bstk {
 
-	bool Config::load_from_file(const std::string& filepath) {
-		std::ifstream file(filepath);
-		if (!file.is_open()) return false;
+	Config::Config(const Config& other)
+		: data_(other.data_), size_hint_(other.size_hint_),
+		instance_names_(other.instance_names_), instance_key_counts_(other.instance_key_counts_),
+		dirty_(other.dirty_), lazy_values_(other.lazy_values_) {
+		// Re-point the order at our own nodes
+		order_.reserve(other.order_.size());
+		for (const Entry* entry : other.order_) {
+			order_.push_back(&*data_.find(entry->first));
+		}
+	}
+
+	Config& Config::operator=(const Config& other) {
+		if (this != &other) {
+			*this = Config(other);
+		}
+		return *this;
+	}
+
+	Config& Config::operator=(Config&& other) noexcept {
+		if (this != &other) {
+			// Handles on either side refer to nodes that change owner; the slot
+			// tables stay put with bumped generations so they cannot alias new keys
+			invalidate_handles();
+			other.invalidate_handles();
+
+			data_ = std::move(other.data_);
+			order_ = std::move(other.order_);
+			sorted_ = std::move(other.sorted_);
+			size_hint_ = other.size_hint_;
+			instance_names_ = std::move(other.instance_names_);
+			instance_key_counts_ = std::move(other.instance_key_counts_);
+			dirty_ = std::move(other.dirty_);
+			lazy_values_ = other.lazy_values_;
+			// Subscribers and open batches belong to the object, not its content.
+			// Like a load, the new content cannot be rolled back on either side.
+			drop_undo_log();
+			other.drop_undo_log();
+		}
+		return *this;
+	}
 
-		std::stringstream buffer;
-		buffer << file.rdbuf();
-		return load_from_string(buffer.str());
+	bool Config::load_from_file(const std::string& filepath) {
+		// Parse straight from the MappedFile view, no further copies
+		MappedFile file;
+		if (!file.open(filepath)) return false;
+		return load_from_string(file.view());
 	}
 
 	bool Config::load_from_string(std::string_view content) {
@@ -20,75 +65,372 @@ namespace bstk {
 		return true;
 	}
 
-	bool Config::save_to_file(const std::string& filepath) const {
+	bool Config::load_from_file_parallel(const std::string& filepath, unsigned threads) {
+		MappedFile file;
+		if (!file.open(filepath)) return false;
+		return load_from_string_parallel(file.view(), threads);
+	}
+
+	bool Config::load_from_string_parallel(std::string_view content, unsigned threads) {
+		clear();
+		parse_content_parallel(content, threads);
+		return true;
+	}
+
+	bool Config::reload_from_file(const std::string& filepath, std::vector<std::string>& changed) {
+		MappedFile file;
+		if (!file.open(filepath)) return false;
+		return reload_from_string(file.view(), changed);
+	}
+
+	bool Config::reload_from_string(std::string_view content, std::vector<std::string>& changed) {
+		Config fresh;
+		fresh.lazy_values_ = lazy_values_;
+		fresh.parse_content(content);
+
+		NotificationBatch batch(*this);
+		// Like a load, a reload inside a batch cannot be rolled back
+		drop_undo_log();
+
+		// Removals first, so erased nodes are gone before new ones go in
+		for (auto it = data_.begin(); it != data_.end();) {
+			if (fresh.data_.find(it->first) != fresh.data_.end()) {
+				++it;
+				continue;
+			}
+			changed.push_back(it->first);
+			notify_change(it->first);
+			on_erase(*it);
+			it = data_.erase(it);
+		}
+
+		for (auto& [key, value] : fresh.data_) {
+			auto it = data_.find(key);
+			if (it == data_.end()) {
+				changed.push_back(key);
+				notify_change(key);
+				on_insert(*data_.emplace(key, std::move(value)).first);
+			}
+			else if (!(it->second == value)) {
+				changed.push_back(key);
+				notify_change(key);
+				it->second = std::move(value);
+			}
+		}
+
+		// Memory matches the file again
+		dirty_.clear();
+		return true;
+	}
+
+	bool Config::save_to_file(const std::string& filepath, SerializeOrder order) const {
 		std::ofstream file(filepath);
 		if (!file.is_open()) return false;
-		file << to_string();
-		return file.good();
+		std::string content = to_string(order);
+		file.write(content.data(), static_cast<std::streamsize>(content.size()));
+		if (!file.good()) return false;
+		dirty_.clear();
+		return true;
 	}
 
-	std::string Config::to_string() const {
-		std::ostringstream oss;
+	bool Config::save_patch(const std::string& filepath, bool durable) {
+		MappedFile original;
+		if (!original.open(filepath)) {
+			return save_atomic(filepath, durable, SerializeOrder::Insertion);
+		}
+		if (dirty_.empty()) return true;
+
+		std::string_view text = original.view();
+		std::string out;
+		out.reserve(text.size() + dirty_.size() * 64);
+
+		// Copy untouched lines as whole ranges, replace or drop dirty ones
+		std::unordered_set<std::string_view> written;
+		size_t copy_from = 0;
+		size_t line_start = 0;
+		while (line_start < text.size()) {
+			size_t line_end = text.find('\n', line_start);
+			size_t next = (line_end == std::string_view::npos) ? text.size() : line_end + 1;
+			std::string_view line = text.substr(line_start, next - line_start);
+
+			auto span = Parser::split_line(line);
+			auto dirty = span ? dirty_.find(span->key) : dirty_.end();
+			if (dirty != dirty_.end()) {
+				out.append(text.data() + copy_from, line_start - copy_from);
+				copy_from = next;
 
-		// Group by prefix for better organization
-		std::vector<std::string> keys;
-		keys.reserve(data_.size());
-		for (const auto& [k, v] : data_) {
-			keys.push_back(k);
+				auto it = data_.find(span->key);
+				if (it != data_.end() && written.insert(it->first).second) {
+					append_entry(out, *it);
+					// Keep the file's line ending
+					if (line.size() >= 2 && line[line.size() - 2] == '\r') {
+						out.insert(out.size() - 1, 1, '\r');
+					}
+					else if (line.back() != '\n') {
+						out.pop_back();
+					}
+				}
+			}
+			line_start = next;
 		}
-		std::sort(keys.begin(), keys.end());
+		out.append(text.data() + copy_from, text.size() - copy_from);
 
-		std::string last_prefix;
-		for (const auto& key : keys) {
+		// Keys the file never had go at the end
+		std::vector<const Entry*> added;
+		for (const auto& key : dirty_) {
 			auto it = data_.find(key);
-			if (it == data_.end()) continue;
-
-			// Add blank line between different top-level sections
-			size_t first_dot = key.find('.');
-			if (first_dot != std::string::npos) {
-				std::string prefix = key.substr(0, first_dot);
-				if (!last_prefix.empty() && prefix != last_prefix) {
-					oss << "\n";
+			if (it != data_.end() && !written.contains(it->first)) {
+				added.push_back(&*it);
+			}
+		}
+		if (!added.empty()) {
+			std::sort(added.begin(), added.end(), KeyLess{});
+			if (!out.empty() && out.back() != '\n') out += '\n';
+			for (const Entry* entry : added) {
+				append_entry(out, *entry);
+			}
+		}
+
+		// The mapping must be gone before the file is replaced
+		original.close();
+
+		// Renamed over the original, a failed write leaves it untouched
+		AtomicFile file(filepath);
+		std::vector<std::string> chunks;
+		chunks.push_back(std::move(out));
+		if (!file.open() || !file.write(chunks)) return false;
+		if (durable && !file.sync()) return false;
+		if (!file.commit()) return false;
+		if (durable) AtomicFile::sync_directory(AtomicFile::parent_directory(filepath));
+		dirty_.clear();
+		return true;
+	}
+
+	std::vector<std::string> Config::dirty_keys() const {
+		return { dirty_.begin(), dirty_.end() };
+	}
+
+	std::string Config::to_string(SerializeOrder order) const {
+		auto chunks = serialize_chunks(order, SIZE_MAX);
+		return std::move(chunks.front());
+	}
+
+	std::vector<std::string> Config::serialize_chunks(SerializeOrder order, size_t chunk_size) const {
+		std::vector<std::string> chunks(1);
+		chunks.back().reserve(std::min(chunk_size, std::max(size_hint_, data_.size() * 48)));
+		size_t total = 0;
+
+		// Start a new buffer once the current one is full
+		auto sink = [&]() -> std::string& {
+			if (chunks.back().size() >= chunk_size) {
+				total += chunks.back().size();
+				chunks.emplace_back().reserve(chunk_size + 256);
+			}
+			return chunks.back();
+		};
+
+		if (order == SerializeOrder::Insertion) {
+			// Single pass over the entries in the order they were first seen
+			for (const Entry* entry : order_) {
+				append_entry(sink(), *entry);
+			}
+		}
+		else {
+			// Group by prefix for better organization
+			std::string_view last_prefix;
+			for (const Entry* entry : sorted_entries()) {
+				std::string& out = sink();
+
+				// Add blank line between different top-level sections
+				std::string_view key = entry->first;
+				size_t first_dot = key.find('.');
+				if (first_dot != std::string_view::npos) {
+					std::string_view prefix = key.substr(0, first_dot);
+					if (!last_prefix.empty() && prefix != last_prefix) {
+						out += '\n';
+					}
+					last_prefix = prefix;
 				}
-				last_prefix = prefix;
+				append_entry(out, *entry);
 			}
+		}
 
-			oss << key << "=" << it->second.to_string() << "\n";
+		size_hint_ = total + chunks.back().size();
+		return chunks;
+	}
+
+	bool Config::save_atomic(const std::string& filepath, bool durable, SerializeOrder order) const {
+		return save_all_atomic({ { this, filepath } }, durable, order) == 1;
+	}
+
+	size_t Config::save_all_atomic(const std::vector<SaveTarget>& targets, bool durable, SerializeOrder order) {
+		constexpr size_t chunk_size = 64 * 1024;
+
+		// Write every temporary file first, one serialization each
+		std::vector<AtomicFile> files;
+		std::vector<const Config*> configs;
+		files.reserve(targets.size());
+		configs.reserve(targets.size());
+		for (const auto& target : targets) {
+			AtomicFile file(target.filepath);
+			if (!file.open() || !file.write(target.config->serialize_chunks(order, chunk_size))) continue;
+			files.push_back(std::move(file));
+			configs.push_back(target.config);
+		}
+
+		// Batch the flushes: kick off writeback for all, then wait for each
+		std::vector<bool> ok(files.size(), true);
+		if (durable) {
+			for (auto& file : files) file.start_sync();
+			for (size_t i = 0; i < files.size(); ++i) ok[i] = files[i].sync();
 		}
 
-		return oss.str();
+		size_t saved = 0;
+		std::vector<std::string> directories;
+		for (size_t i = 0; i < files.size(); ++i) {
+			if (!ok[i] || !files[i].commit()) continue;
+			configs[i]->dirty_.clear();
+			++saved;
+
+			std::string directory = AtomicFile::parent_directory(files[i].target());
+			if (std::find(directories.begin(), directories.end(), directory) == directories.end()) {
+				directories.push_back(std::move(directory));
+			}
+		}
+
+		// Persist the renames once per directory
+		if (durable) {
+			for (const auto& directory : directories) AtomicFile::sync_directory(directory);
+		}
+		return saved;
+	}
+
+	void Config::append_entry(std::string& out, const Entry& entry) {
+		out += entry.first;
+		out += '=';
+		entry.second.append_to(out);
+		out += '\n';
 	}
 
 	bool Config::has(std::string_view key) const {
-		return data_.find(std::string(key)) != data_.end();
+		return data_.find(key) != data_.end();
 	}
 
 	const Value* Config::get(std::string_view key) const {
-		auto it = data_.find(std::string(key));
+		auto it = data_.find(key);
 		if (it != data_.end()) return &it->second;
 		return nullptr;
 	}
 
 	Value* Config::get(std::string_view key) {
-		auto it = data_.find(std::string(key));
+		auto it = data_.find(key);
 		if (it != data_.end()) return &it->second;
 		return nullptr;
 	}
 
 	void Config::set(std::string_view key, const Value& value) {
-		std::string k(key);
-		if (!data_.contains(k)) {
-			modified_keys_.push_back(k);
-		}
-		data_[k] = value;
+		set(key, Value(value));
 	}
 
 	void Config::set(std::string_view key, Value&& value) {
-		std::string k(key);
-		if (!data_.contains(k)) {
-			modified_keys_.push_back(k);
+		// Only a newly inserted key pays for a std::string
+		auto it = data_.find(key);
+		if (it != data_.end()) {
+			assign(*it, std::move(value));
+			return;
 		}
-		data_[k] = std::move(value);
+		if (in_batch()) log_undo(key, nullptr);
+		it = data_.emplace(std::string(key), std::move(value)).first;
+		on_insert(*it);
+		mark_dirty(it->first);
+		notify_change(it->first);
+	}
+
+	void Config::assign(Entry& entry, Value&& value) {
+		// The caller's kind is always stored, but the same text is no change
+		// on disk: it is neither dirty nor announced
+		if (entry.second == value) return;
+		bool same_text = entry.second.same_text(value);
+		if (in_batch()) log_undo(entry.first, &entry.second);
+		entry.second = std::move(value);
+		if (same_text) return;
+		mark_dirty(entry.first);
+		notify_change(entry.first);
+	}
+
+	KeyHandle Config::resolve(std::string_view key) {
+		auto it = data_.find(key);
+		if (it == data_.end()) return {};
+
+		Entry* entry = &*it;
+		auto existing = handle_slot_of_.find(entry);
+		if (existing != handle_slot_of_.end()) {
+			return { existing->second, handle_slots_[existing->second].generation };
+		}
+
+		uint32_t slot;
+		if (!free_handle_slots_.empty()) {
+			slot = free_handle_slots_.back();
+			free_handle_slots_.pop_back();
+		}
+		else {
+			slot = static_cast<uint32_t>(handle_slots_.size());
+			handle_slots_.emplace_back();
+			// Room to free every slot later without allocating; follows the
+			// slot table's geometric growth, so this rarely reallocates
+			free_handle_slots_.reserve(handle_slots_.capacity());
+		}
+		handle_slots_[slot].entry = entry;
+		handle_slot_of_.emplace(entry, slot);
+		return { slot, handle_slots_[slot].generation };
+	}
+
+	Config::Entry* Config::entry_of(KeyHandle handle) const noexcept {
+		if (handle.slot >= handle_slots_.size()) return nullptr;
+		const HandleSlot& slot = handle_slots_[handle.slot];
+		return slot.generation == handle.generation ? slot.entry : nullptr;
+	}
+
+	const Value* Config::get(KeyHandle handle) const {
+		const Entry* entry = entry_of(handle);
+		return entry ? &entry->second : nullptr;
+	}
+
+	Value* Config::get(KeyHandle handle) {
+		Entry* entry = entry_of(handle);
+		return entry ? &entry->second : nullptr;
+	}
+
+	bool Config::set(KeyHandle handle, const Value& value) {
+		return set(handle, Value(value));
+	}
+
+	bool Config::set(KeyHandle handle, Value&& value) {
+		Entry* entry = entry_of(handle);
+		if (!entry) return false;
+		assign(*entry, std::move(value));
+		return true;
+	}
+
+	void Config::invalidate_handles() noexcept {
+		// Outstanding handles go stale. The free list was reserved for every
+		// slot when it was created, so this never allocates.
+		for (const auto& [entry, slot] : handle_slot_of_) {
+			handle_slots_[slot].entry = nullptr;
+			++handle_slots_[slot].generation;
+			free_handle_slots_.push_back(slot);
+		}
+		handle_slot_of_.clear();
+	}
+
+	void Config::release_handle(const Entry& entry) {
+		auto it = handle_slot_of_.find(&entry);
+		if (it == handle_slot_of_.end()) return;
+		HandleSlot& slot = handle_slots_[it->second];
+		slot.entry = nullptr;
+		++slot.generation;
+		free_handle_slots_.push_back(it->second);
+		handle_slot_of_.erase(it);
 	}
 
 	void Config::set_string(std::string_view key, std::string_view value) {
@@ -108,77 +450,276 @@ namespace bstk {
 	}
 
 	bool Config::remove(std::string_view key) {
-		auto it = data_.find(std::string(key));
+		auto it = data_.find(key);
 		if (it != data_.end()) {
+			if (in_batch()) {
+				log_undo(key, &it->second, static_cast<size_t>(std::find(order_.begin(), order_.end(), &*it) - order_.begin()));
+			}
+			mark_dirty(it->first);
+			notify_change(it->first);
+			on_erase(*it);
 			data_.erase(it);
-			modified_keys_.erase(
-				std::remove(modified_keys_.begin(), modified_keys_.end(), std::string(key)),
-				modified_keys_.end()
-			);
 			return true;
 		}
 		return false;
 	}
 
+	void Config::clear() noexcept {
+		data_.clear();
+		order_.clear();
+		sorted_.entries.clear();
+		sorted_.invalidate();
+		instance_names_.clear();
+		instance_key_counts_.clear();
+		dirty_.clear();
+
+		invalidate_handles();
+
+		// A load inside a batch cannot be rolled back
+		drop_undo_log();
+	}
+
+	void Config::drop_undo_log() noexcept {
+		// Open batches stay open, they just have nothing left to undo
+		undo_log_.clear();
+		std::fill(savepoints_.begin(), savepoints_.end(), 0);
+	}
+
+	void Config::mark_dirty(std::string_view key) {
+		if (!dirty_.contains(key)) dirty_.emplace(key);
+	}
+
+	void Config::on_insert(const Entry& entry) {
+		order_.push_back(&entry);
+		register_instance_key(entry.first);
+		// Mutation has exclusive access, the index is updated without its lock.
+		// Batches drop it and rebuild it once afterwards.
+		auto& sorted = sorted_.entries;
+		if (in_batch()) sorted_.invalidate();
+		if (sorted_.valid.load(std::memory_order_relaxed)) {
+			sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), &entry, KeyLess{}), &entry);
+		}
+	}
+
+	void Config::on_erase(const Entry& entry) {
+		order_.erase(std::find(order_.begin(), order_.end(), &entry));
+		if (!handle_slot_of_.empty()) release_handle(entry);
+		unregister_instance_key(entry.first);
+		auto& sorted = sorted_.entries;
+		if (in_batch()) sorted_.invalidate();
+		if (sorted_.valid.load(std::memory_order_relaxed)) {
+			sorted.erase(std::lower_bound(sorted.begin(), sorted.end(), &entry, KeyLess{}));
+		}
+	}
+
+	const std::vector<const Config::Entry*>& Config::sorted_entries() const {
+		// Built on first use after a bulk load, maintained incrementally after that
+		if (!sorted_.valid.load(std::memory_order_acquire)) {
+			std::lock_guard<std::mutex> lock(sorted_.mutex);
+			if (!sorted_.valid.load(std::memory_order_relaxed)) {
+				sorted_.entries.assign(order_.begin(), order_.end());
+				std::sort(sorted_.entries.begin(), sorted_.entries.end(), KeyLess{});
+				sorted_.valid.store(true, std::memory_order_release);
+			}
+		}
+		return sorted_.entries;
+	}
+
+	std::span<const Config::Entry* const> Config::prefix_range(std::string_view prefix, std::string_view tail) const {
+		const auto& sorted = sorted_entries();
+		KeyLess::Split key{ prefix, tail };
+		auto first = std::lower_bound(sorted.begin(), sorted.end(), key, KeyLess{});
+		auto last = std::partition_point(first, sorted.end(),
+			[&key](const Entry* entry) { return KeyLess::starts_with(entry->first, key); });
+		return { first, last };
+	}
+
 	std::vector<std::string> Config::get_keys_with_prefix(std::string_view prefix) const {
+		auto range = prefix_range(prefix);
 		std::vector<std::string> result;
-		for (const auto& [k, v] : data_) {
-			if (k.size() >= prefix.size() &&
-				std::string_view(k).substr(0, prefix.size()) == prefix) {
-				result.push_back(k);
-			}
+		result.reserve(range.size());
+		for (const Entry* entry : range) {
+			result.push_back(entry->first);
 		}
 		return result;
 	}
 
 	Config Config::get_namespace(std::string_view prefix) const {
 		Config result;
-		std::string p(prefix);
-		if (!p.empty() && p.back() != '.') p += '.';
+		std::string_view dot = (!prefix.empty() && prefix.back() != '.') ? "." : "";
+		size_t skip = prefix.size() + dot.size();
 
-		for (const auto& [k, v] : data_) {
-			if (k.size() > p.size() && k.substr(0, p.size()) == p) {
-				result.set(k.substr(p.size()), v);
+		auto range = prefix_range(prefix, dot);
+		result.data_.reserve(range.size());
+		for (const Entry* entry : range) {
+			if (entry->first.size() > skip) {
+				result.insert_parsed(std::string_view(entry->first).substr(skip), Value(entry->second));
 			}
 		}
 		return result;
 	}
 
 	std::vector<std::string> Config::get_instance_names() const {
-		std::vector<std::string> names;
-		std::string prefix = "bst.instance.";
-
-		for (const auto& [k, v] : data_) {
-			if (k.size() > prefix.size() && k.substr(0, prefix.size()) == prefix) {
-				size_t dot_pos = k.find('.', prefix.size());
-				if (dot_pos != std::string::npos) {
-					std::string name = k.substr(prefix.size(), dot_pos - prefix.size());
-					if (std::find(names.begin(), names.end(), name) == names.end()) {
-						names.push_back(name);
-					}
-				}
-			}
+		return instance_names_;
+	}
+
+	std::optional<std::string_view> Config::instance_name_of(std::string_view key) noexcept {
+		if (key.size() <= instance_prefix.size() || !key.starts_with(instance_prefix)) return std::nullopt;
+		size_t dot_pos = key.find('.', instance_prefix.size());
+		if (dot_pos == std::string_view::npos) return std::nullopt;
+		return key.substr(instance_prefix.size(), dot_pos - instance_prefix.size());
+	}
+
+	void Config::register_instance_key(std::string_view key) {
+		auto name = instance_name_of(key);
+		if (!name) return;
+		auto it = instance_key_counts_.find(*name);
+		if (it != instance_key_counts_.end()) {
+			++it->second;
+			return;
 		}
-		return names;
+		instance_key_counts_.emplace(std::string(*name), 1);
+		instance_names_.emplace_back(*name);
+	}
+
+	void Config::unregister_instance_key(std::string_view key) {
+		auto name = instance_name_of(key);
+		if (!name) return;
+		auto it = instance_key_counts_.find(*name);
+		if (it == instance_key_counts_.end() || --it->second > 0) return;
+		instance_names_.erase(std::find(instance_names_.begin(), instance_names_.end(), *name));
+		instance_key_counts_.erase(it);
 	}
 
 	Config Config::get_instance_config(std::string_view instance_name) const {
-		return get_namespace(std::string("bst.instance.") + std::string(instance_name));
+		return get_namespace(std::string(instance_prefix) + std::string(instance_name));
+	}
+
+	size_t Config::estimate_line_count(std::string_view content) {
+		// Extrapolate from the line density of a leading sample
+		constexpr size_t sample_size = 64 * 1024;
+		std::string_view sample = content.substr(0, sample_size);
+		size_t lines = static_cast<size_t>(std::count(sample.begin(), sample.end(), '\n'));
+		if (sample.size() < content.size()) {
+			lines = static_cast<size_t>(static_cast<double>(lines) * content.size() / sample.size());
+		}
+		return lines + 1;
+	}
+
+	Value Config::make_parsed_value(std::string_view raw_value) const {
+		return lazy_values_ ? Value::lazy(raw_value) : Parser::parse_value(raw_value);
+	}
+
+	void Config::insert_parsed(std::string_view key, Value&& value) {
+		auto it = data_.find(key);
+		if (it != data_.end()) {
+			it->second = std::move(value);
+			return;
+		}
+		on_insert(*data_.emplace(std::string(key), std::move(value)).first);
+	}
+
+	void Config::insert_parsed(std::string&& key, Value&& value) {
+		auto [it, inserted] = data_.try_emplace(std::move(key), std::move(value));
+		if (!inserted) {
+			it->second = std::move(value);
+			return;
+		}
+		on_insert(*it);
 	}
 
 	void Config::parse_content(std::string_view content) {
-		size_t line_start = 0;
-		while (line_start < content.size()) {
-			size_t line_end = content.find('\n', line_start);
-			if (line_end == std::string_view::npos) line_end = content.size();
+		// Bulk insert, the sorted index is rebuilt on its next use
+		sorted_.invalidate();
+		size_t expected = estimate_line_count(content);
+		data_.reserve(data_.size() + expected);
+		order_.reserve(order_.size() + expected);
 
-			std::string_view line = content.substr(line_start, line_end - line_start);
-			if (auto parsed = Parser::parse_line(line)) {
-				data_[parsed->key] = Parser::infer_value(parsed->value);
-				modified_keys_.push_back(parsed->key);
+		Tokenizer tokenizer(content);
+		LineSpan span;
+		while (tokenizer.next(span)) {
+			insert_parsed(span.key, make_parsed_value(span.value));
+		}
+	}
+
+	void Config::parse_content_parallel(std::string_view content, unsigned threads) {
+		sorted_.invalidate();
+		if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+		// Not worth a thread below ~256 KiB per chunk
+		constexpr size_t min_chunk = 256 * 1024;
+		threads = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(1, content.size() / min_chunk)));
+		if (threads <= 1) {
+			parse_content(content);
+			return;
+		}
+
+		// Split at newline boundaries
+		std::vector<std::string_view> chunks;
+		chunks.reserve(threads);
+		size_t start = 0;
+		for (unsigned i = 1; i <= threads && start < content.size(); ++i) {
+			size_t end = content.size();
+			if (i < threads) {
+				end = content.find('\n', std::max(start, content.size() / threads * i));
+				end = (end == std::string_view::npos) ? content.size() : end + 1;
 			}
+			chunks.push_back(content.substr(start, end - start));
+			start = end;
+		}
+
+		// Each chunk parses into its own ordered table
+		using Table = std::vector<std::pair<std::string, Value>>;
+		std::vector<Table> tables(chunks.size());
+		std::vector<std::exception_ptr> errors(chunks.size());
 
-			line_start = line_end + 1;
+		auto parse_chunk = [&](size_t index) {
+			try {
+				Table& table = tables[index];
+				table.reserve(estimate_line_count(chunks[index]));
+				Tokenizer tokenizer(chunks[index]);
+				LineSpan span;
+				while (tokenizer.next(span)) {
+					table.emplace_back(std::string(span.key), make_parsed_value(span.value));
+				}
+			}
+			catch (...) {
+				errors[index] = std::current_exception();
+			}
+		};
+
+		// jthreads join when destroyed, so nothing is left joinable if a spawn
+		// fails; chunks that got no thread are parsed here instead
+		size_t spawned = 1;
+		{
+			std::vector<std::jthread> workers;
+			workers.reserve(chunks.size() - 1);
+			try {
+				for (; spawned < chunks.size(); ++spawned) {
+					workers.emplace_back(parse_chunk, spawned);
+				}
+			}
+			catch (const std::system_error&) {
+			}
+			parse_chunk(0);
+			for (size_t i = spawned; i < chunks.size(); ++i) parse_chunk(i);
+		}
+
+		for (const auto& error : errors) {
+			if (error) std::rethrow_exception(error);
+		}
+
+		// Merge in file order so later lines win
+		size_t total = 0;
+		for (const auto& table : tables) total += table.size();
+		data_.reserve(data_.size() + total);
+		order_.reserve(order_.size() + total);
+
+		for (auto& table : tables) {
+			for (auto& [key, value] : table) {
+				insert_parsed(std::move(key), std::move(value));
+			}
+			Table().swap(table);
 		}
 	}
 
@@ -0,0 +1,77 @@
+#include "bstk/config.hpp"
+#include <algorithm>
+
+namespace bstk {
+
+	void Config::begin_batch() {
+		savepoints_.push_back(undo_log_.size());
+		// Hold notifications like a NotificationBatch would
+		++batch_depth_;
+	}
+
+	bool Config::commit() {
+		if (savepoints_.empty()) return false;
+
+		// The parent batch still needs the records to undo this level
+		savepoints_.pop_back();
+		if (savepoints_.empty()) undo_log_.clear();
+		end_batch();
+		return true;
+	}
+
+	bool Config::rollback() {
+		return rollback_batch(false);
+	}
+
+	bool Config::rollback_batch(bool contain_errors) {
+		if (savepoints_.empty()) return false;
+
+		size_t savepoint = savepoints_.back();
+		savepoints_.pop_back();
+		while (undo_log_.size() > savepoint) {
+			undo(undo_log_.back());
+			undo_log_.pop_back();
+		}
+		end_batch(contain_errors);
+		return true;
+	}
+
+	void Config::end_batch(bool contain_errors) {
+		if (--batch_depth_ == 0) deliver_notifications(contain_errors);
+	}
+
+	void Config::log_undo(std::string_view key, const Value* previous, size_t order_index) {
+		UndoRecord record{ std::string(key), std::nullopt, order_index, dirty_.contains(key), false };
+		if (previous) record.previous = *previous;
+		if (subscriptions_) record.was_pending = subscriptions_->pending_set.contains(key);
+		undo_log_.push_back(std::move(record));
+	}
+
+	void Config::undo(UndoRecord& record) {
+		// Put the key back as it was, whatever happened to it since
+		auto it = data_.find(record.key);
+		if (!record.previous) {
+			if (it != data_.end()) {
+				on_erase(*it);
+				data_.erase(it);
+			}
+		}
+		else if (it != data_.end()) {
+			it->second = std::move(*record.previous);
+		}
+		else {
+			it = data_.emplace(record.key, std::move(*record.previous)).first;
+			on_insert(*it);
+			// Back to its original place in insertion order
+			order_.pop_back();
+			order_.insert(order_.begin() + static_cast<std::ptrdiff_t>(std::min(record.order_index, order_.size())), &*it);
+		}
+
+		if (!record.was_dirty) dirty_.erase(record.key);
+		if (!record.was_pending && subscriptions_ && subscriptions_->pending_set.erase(record.key)) {
+			auto& pending = subscriptions_->pending;
+			pending.erase(std::find(pending.begin(), pending.end(), record.key));
+		}
+	}
+
+} // namespace bstk
\ No newline at end of file
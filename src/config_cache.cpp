@@ -0,0 +1,289 @@
+#include "bstk/config_cache.hpp"
+#include "bstk/atomic_file.hpp"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace bstk {
+
+	struct ConfigCache::Header {
+		char magic[8];
+		uint32_t version;
+		uint32_t byte_order;  // Reads back differently on a foreign architecture
+		uint64_t source_hash;
+		uint64_t source_size;
+		uint64_t count;
+		uint64_t pool_size;
+	};
+
+	struct ConfigCache::Record {
+		uint32_t key_offset;
+		uint32_t key_size;
+		uint8_t type;
+		uint8_t reserved[7];
+		uint64_t payload; // int64 or double bits, bool, or string offset | size << 32
+	};
+
+	namespace {
+
+		constexpr char cache_magic[8] = { 'B', 'S', 'T', 'K', 'C', 'A', 'C', 'H' };
+		constexpr uint32_t cache_version = 1;
+		constexpr uint32_t cache_byte_order = 0x01020304;
+
+		enum RecordType : uint8_t { String, Int, Double, Bool };
+
+		constexpr size_t align8(size_t n) noexcept { return (n + 7) & ~size_t{ 7 }; }
+
+		uint64_t string_payload(uint32_t offset, uint32_t size) noexcept {
+			return offset | (static_cast<uint64_t>(size) << 32);
+		}
+
+	} // namespace
+
+	size_t ConfigCache::records_offset() noexcept {
+		return align8(sizeof(Header));
+	}
+
+	uint64_t ConfigCache::hash(std::string_view content) noexcept {
+		// Word-at-a-time multiply/rotate mix, plenty for change detection
+		constexpr uint64_t prime = 0x9E3779B97F4A7C15ull;
+		uint64_t h = prime ^ content.size();
+		const char* p = content.data();
+		size_t n = content.size();
+		for (; n >= 8; p += 8, n -= 8) {
+			uint64_t word;
+			std::memcpy(&word, p, 8);
+			h = ((h ^ word) * prime);
+			h ^= h >> 29;
+		}
+		if (n > 0) {
+			uint64_t word = 0;
+			std::memcpy(&word, p, n);
+			h = ((h ^ word) * prime);
+		}
+		h ^= h >> 32;
+		return h * prime;
+	}
+
+	bool ConfigCache::write(const Config& config, std::string_view source, const std::string& path) {
+		std::vector<const Config::Entry*> sorted;
+		sorted.reserve(config.size());
+		for (const auto& entry : config) sorted.push_back(&entry);
+		std::sort(sorted.begin(), sorted.end(), [](const Config::Entry* a, const Config::Entry* b) { return a->first < b->first; });
+
+		std::string pool;
+		auto intern = [&pool](std::string_view text) {
+			uint32_t offset = static_cast<uint32_t>(pool.size());
+			pool.append(text.data(), text.size());
+			return offset;
+		};
+
+		std::vector<Record> records(sorted.size());
+		for (size_t i = 0; i < sorted.size(); ++i) {
+			const auto& [key, value] = *sorted[i];
+			Record& record = records[i];
+			record = {};
+			record.key_offset = intern(key);
+			record.key_size = static_cast<uint32_t>(key.size());
+			if (value.is_int()) {
+				int64_t v = value.as_int();
+				record.type = Int;
+				std::memcpy(&record.payload, &v, sizeof(v));
+			}
+			else if (value.is_double()) {
+				double v = value.as_double();
+				record.type = Double;
+				std::memcpy(&record.payload, &v, sizeof(v));
+			}
+			else if (value.is_bool()) {
+				record.type = Bool;
+				record.payload = value.as_bool() ? 1 : 0;
+			}
+			else {
+				std::string_view text = value.as_string_view();
+				record.type = String;
+				record.payload = string_payload(intern(text), static_cast<uint32_t>(text.size()));
+			}
+			if (pool.size() > UINT32_MAX) return false;
+		}
+
+		// Insertion order as indices into the sorted table
+		std::vector<uint32_t> order;
+		order.reserve(sorted.size());
+		{
+			std::unordered_map<const Config::Entry*, uint32_t> index_of;
+			index_of.reserve(sorted.size());
+			for (size_t i = 0; i < sorted.size(); ++i) index_of.emplace(sorted[i], static_cast<uint32_t>(i));
+			for (const Config::Entry* entry : config.order_) order.push_back(index_of.at(entry));
+		}
+
+		Header header{};
+		std::memcpy(header.magic, cache_magic, sizeof(cache_magic));
+		header.version = cache_version;
+		header.byte_order = cache_byte_order;
+		header.source_hash = hash(source);
+		header.source_size = source.size();
+		header.count = records.size();
+		header.pool_size = pool.size();
+
+		size_t pool_offset = align8(records_offset() + records.size() * sizeof(Record) + order.size() * sizeof(uint32_t));
+		std::string tables(pool_offset, '\0');
+		std::memcpy(tables.data(), &header, sizeof(header));
+		if (!records.empty()) {
+			std::memcpy(tables.data() + records_offset(), records.data(), records.size() * sizeof(Record));
+			std::memcpy(tables.data() + records_offset() + records.size() * sizeof(Record), order.data(), order.size() * sizeof(uint32_t));
+		}
+
+		// A cache is rebuilt on demand, no need to wait for the disk
+		AtomicFile file(path);
+		return file.open() && file.write({ std::move(tables), std::move(pool) }) && file.commit();
+	}
+
+	bool ConfigCache::open(const std::string& path) {
+		close();
+		if (!file_.open(path)) return false;
+
+		const char* base = file_.data();
+		size_t size = file_.size();
+		if (size < records_offset()) {
+			close();
+			return false;
+		}
+
+		const auto* header = reinterpret_cast<const Header*>(base);
+		if (std::memcmp(header->magic, cache_magic, sizeof(cache_magic)) != 0 ||
+			header->version != cache_version || header->byte_order != cache_byte_order ||
+			header->count > UINT32_MAX || header->pool_size > UINT32_MAX) {
+			close();
+			return false;
+		}
+
+		size_t count = static_cast<size_t>(header->count);
+		size_t pool_offset = align8(records_offset() + count * sizeof(Record) + count * sizeof(uint32_t));
+		if (pool_offset + header->pool_size != size) {
+			close();
+			return false;
+		}
+
+		// Bounds-check every reference once so lookups can trust the tables
+		const auto* records = reinterpret_cast<const Record*>(base + records_offset());
+		const auto* order = reinterpret_cast<const uint32_t*>(base + records_offset() + count * sizeof(Record));
+		uint64_t pool_size = header->pool_size;
+		for (size_t i = 0; i < count; ++i) {
+			const Record& record = records[i];
+			bool ok = record.type <= Bool && uint64_t{ record.key_offset } + record.key_size <= pool_size && order[i] < count;
+			if (ok && record.type == String) {
+				ok = (record.payload & 0xFFFFFFFFu) + (record.payload >> 32) <= pool_size;
+			}
+			if (!ok) {
+				close();
+				return false;
+			}
+		}
+
+		header_ = header;
+		records_ = records;
+		order_ = order;
+		pool_ = base + pool_offset;
+		return true;
+	}
+
+	void ConfigCache::close() noexcept {
+		file_.close();
+		header_ = nullptr;
+		records_ = nullptr;
+		order_ = nullptr;
+		pool_ = nullptr;
+	}
+
+	bool ConfigCache::matches(std::string_view source) const {
+		return header_ && header_->source_size == source.size() && header_->source_hash == hash(source);
+	}
+
+	size_t ConfigCache::size() const noexcept {
+		return header_ ? static_cast<size_t>(header_->count) : 0;
+	}
+
+	std::string_view ConfigCache::key_of(const Record& record) const noexcept {
+		return { pool_ + record.key_offset, record.key_size };
+	}
+
+	const ConfigCache::Record* ConfigCache::find(std::string_view key) const {
+		if (!header_) return nullptr;
+		const Record* end = records_ + size();
+		const Record* it = std::lower_bound(records_, end, key,
+			[this](const Record& record, std::string_view k) { return key_of(record) < k; });
+		return it != end && key_of(*it) == key ? it : nullptr;
+	}
+
+	Value ConfigCache::value_of(const Record& record) const {
+		switch (record.type) {
+		case Int: {
+			int64_t v;
+			std::memcpy(&v, &record.payload, sizeof(v));
+			return Value(v);
+		}
+		case Double: {
+			double v;
+			std::memcpy(&v, &record.payload, sizeof(v));
+			return Value(v);
+		}
+		case Bool: return Value(record.payload != 0);
+		default: return Value(std::string_view(pool_ + (record.payload & 0xFFFFFFFFu), static_cast<size_t>(record.payload >> 32)));
+		}
+	}
+
+	std::optional<Value> ConfigCache::get(std::string_view key) const {
+		const Record* record = find(key);
+		if (!record) return std::nullopt;
+		return value_of(*record);
+	}
+
+	void ConfigCache::load_into(Config& config) const {
+		config.clear();
+		size_t count = size();
+		config.data_.reserve(count);
+		config.order_.reserve(count);
+
+		// The table is key-sorted, so the sorted index comes for free as long
+		// as every record lands in its own entry
+		std::vector<const Config::Entry*> by_record(count);
+		bool unique = true;
+		for (size_t i = 0; i < count; ++i) {
+			const Record& record = records_[order_[i]];
+			// Keys are unique in a cache we wrote, one hash per insert
+			auto [it, inserted] = config.data_.try_emplace(std::string(key_of(record)), value_of(record));
+			if (!inserted) {
+				it->second = value_of(record);
+				unique = false;
+				continue;
+			}
+			config.on_insert(*it);
+			by_record[order_[i]] = &*it;
+		}
+
+		if (unique) {
+			config.sorted_.entries = std::move(by_record);
+			config.sorted_.valid.store(true, std::memory_order_release);
+		}
+	}
+
+	bool Config::load_cached(const std::string& filepath, const std::string& cache_path) {
+		MappedFile source;
+		if (!source.open(filepath)) return false;
+		const std::string& cache = cache_path.empty() ? filepath + ".cache" : cache_path;
+
+		ConfigCache cached;
+		if (cached.open(cache) && cached.matches(source.view())) {
+			cached.load_into(*this);
+			return true;
+		}
+
+		// Stale or missing, parse and rebuild (best effort, e.g. read-only dirs)
+		cached.close();
+		if (!load_from_string(source.view())) return false;
+		ConfigCache::write(*this, source.view(), cache);
+		return true;
+	}
+
+} // namespace bstk
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include "bstk/config_set.hpp"
+#include "bstk/config_view.hpp"
+#include "bstk/mapped_file.hpp"
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+namespace bstk {
+
+	namespace {
+
+		// Fixed set of workers, each with its own task deque. Owners pop from
+		// the back, idle workers steal from the front of someone else's.
+		class StealingPool {
+		public:
+			StealingPool(size_t task_count, unsigned threads) : queues_(threads) {
+				// Deal tasks round-robin so neighbouring (similar) files spread out
+				for (size_t i = 0; i < task_count; ++i) queues_[i % threads].tasks.push_back(i);
+			}
+
+			template<typename Fn>
+			void run(Fn&& fn) {
+				// jthreads join when destroyed, also on unwind. A failed spawn just
+				// means fewer workers; the others steal the orphaned queue.
+				std::vector<std::jthread> workers;
+				workers.reserve(queues_.size() - 1);
+				try {
+					for (size_t w = 1; w < queues_.size(); ++w) {
+						workers.emplace_back([this, w, &fn] { work(w, fn); });
+					}
+				}
+				catch (const std::system_error&) {
+				}
+				work(0, fn);
+			}
+
+		private:
+			struct Queue {
+				std::mutex mutex;
+				std::deque<size_t> tasks;
+			};
+			std::vector<Queue> queues_;
+
+			bool pop(size_t self, size_t& task) {
+				Queue& own = queues_[self];
+				std::lock_guard<std::mutex> lock(own.mutex);
+				if (own.tasks.empty()) return false;
+				task = own.tasks.back();
+				own.tasks.pop_back();
+				return true;
+			}
+
+			bool steal(size_t self, size_t& task) {
+				for (size_t i = 1; i < queues_.size(); ++i) {
+					Queue& victim = queues_[(self + i) % queues_.size()];
+					std::lock_guard<std::mutex> lock(victim.mutex);
+					if (victim.tasks.empty()) continue;
+					task = victim.tasks.front();
+					victim.tasks.pop_front();
+					return true;
+				}
+				return false;
+			}
+
+			// No task is ever added after start, so empty everywhere means done
+			template<typename Fn>
+			void work(size_t self, Fn& fn) {
+				size_t task;
+				while (pop(self, task) || steal(self, task)) fn(task);
+			}
+		};
+
+	} // namespace
+
+	ConfigSet::LoadStats ConfigSet::load(const std::vector<std::string>& paths, unsigned threads) {
+		auto start = std::chrono::steady_clock::now();
+
+		members_.clear();
+		members_.resize(paths.size());
+		for (size_t i = 0; i < paths.size(); ++i) members_[i].path = paths[i];
+
+		if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+		threads = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(1, paths.size())));
+
+		// Each task writes only its own member, no locking needed
+		StealingPool pool(paths.size(), threads);
+		pool.run([this](size_t index) {
+			Member& member = members_[index];
+			auto begin = std::chrono::steady_clock::now();
+			try {
+				// Opened here rather than by load_from_file to keep the OS error
+				MappedFile file;
+				if (file.open(member.path)) member.loaded = member.config.load_from_string(file.view());
+				else member.error = "cannot open file: " + file.error().message();
+			}
+			catch (const std::exception& e) {
+				member.loaded = false;
+				member.error = e.what();
+			}
+			catch (...) {
+				member.loaded = false;
+				member.error = "unknown error";
+			}
+			member.load_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+		});
+
+		LoadStats stats;
+		for (const auto& member : members_) {
+			if (member.loaded) ++stats.loaded;
+			else ++stats.failed;
+		}
+		stats.wall_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+		return stats;
+	}
+
+	ConfigSet::LoadStats ConfigSet::load_directory(const std::string& root, std::string_view filename, unsigned threads) {
+		namespace fs = std::filesystem;
+
+		std::vector<std::string> paths;
+		std::error_code ec;
+		fs::path current = root;
+		fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec);
+		for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+			current = it->path();
+			if (current.filename() != filename) continue;
+			// A name match whose type cannot be read (e.g. a dangling link) is
+			// kept so load reports why it failed
+			std::error_code type_ec;
+			if (it->is_regular_file(type_ec) || type_ec) paths.push_back(current.string());
+		}
+		std::sort(paths.begin(), paths.end());
+
+		LoadStats stats = load(paths, threads);
+		if (ec) stats.error = current.string() + ": " + ec.message();
+		return stats;
+	}
+
+	const ConfigSet::Member* ConfigSet::find(std::string_view path) const {
+		for (const auto& member : members_) {
+			if (member.path == path) return &member;
+		}
+		return nullptr;
+	}
+
+	std::vector<const ConfigSet::Member*> ConfigSet::failed() const {
+		std::vector<const Member*> result;
+		for (const auto& member : members_) {
+			if (!member.loaded) result.push_back(&member);
+		}
+		return result;
+	}
+
+	bool ConfigSet::matches(std::string_view key, std::string_view pattern) noexcept {
+		// Wildcard match with backtracking to the last '*', which may not cross a '.'
+		size_t k = 0, p = 0;
+		size_t star = std::string_view::npos, resume = 0;
+		while (k < key.size()) {
+			if (p < pattern.size() && pattern[p] == '*') {
+				star = p++;
+				resume = k;
+			}
+			else if (p < pattern.size() && pattern[p] == key[k]) {
+				++p;
+				++k;
+			}
+			else if (star != std::string_view::npos && key[resume] != '.') {
+				p = star + 1;
+				k = ++resume;
+			}
+			else {
+				return false;
+			}
+		}
+		while (p < pattern.size() && pattern[p] == '*') ++p;
+		return p == pattern.size();
+	}
+
+	void ConfigSet::for_each_match(std::string_view pattern, const MatchCallback& fn) const {
+		size_t star = pattern.find('*');
+		for (const auto& member : members_) {
+			if (!member.loaded) continue;
+
+			// Plain key, one lookup
+			if (star == std::string_view::npos) {
+				if (const Value* value = member.config.get(pattern)) fn(member, pattern, *value);
+				continue;
+			}
+
+			// Narrow to the literal prefix through the sorted index, then match the rest
+			size_t dot = pattern.rfind('.', star);
+			std::string_view prefix = dot == std::string_view::npos ? std::string_view() : pattern.substr(0, dot + 1);
+			std::string_view rest = pattern.substr(prefix.size());
+			for (const auto& item : member.config.view(prefix)) {
+				if (!matches(item.key, rest)) continue;
+				std::string key(prefix);
+				key += item.key;
+				fn(member, key, item.value);
+			}
+		}
+	}
+
+	std::map<std::string, size_t> ConfigSet::distribution(std::string_view pattern) const {
+		std::map<std::string, size_t> result;
+		for_each_match(pattern, [&result](const Member&, std::string_view, const Value& value) {
+			++result[value.as_string()];
+		});
+		return result;
+	}
+
+	std::vector<const ConfigSet::Member*> ConfigSet::where(std::string_view pattern, std::string_view value) const {
+		return where(pattern, [value](const Value& v) { return v.as_string() == value; });
+	}
+
+	std::vector<const ConfigSet::Member*> ConfigSet::where(std::string_view pattern, const std::function<bool(const Value&)>& pred) const {
+		std::vector<const Member*> result;
+		for_each_match(pattern, [&](const Member& member, std::string_view, const Value& value) {
+			// Matches arrive grouped by member
+			if (!result.empty() && result.back() == &member) return;
+			if (pred(value)) result.push_back(&member);
+		});
+		return result;
+	}
+
+} // namespace bstk
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "bstk/config.hpp"
+#include <algorithm>
+#include <map>
+
+namespace bstk {
+
+	namespace {
+
+		// Visit subscribers of key: exact match, "", then every dotted prefix.
+		// One hash lookup per key segment, independent of the subscriber count.
+		template<typename Map, typename Fn>
+		void for_each_subscriber(const Map& by_pattern, std::string_view key, Fn&& fn) {
+			auto visit = [&](std::string_view pattern) {
+				auto it = by_pattern.find(pattern);
+				if (it == by_pattern.end()) return;
+				for (auto id : it->second) fn(id);
+			};
+
+			visit(key);
+			visit(std::string_view());
+			for (size_t dot = key.find('.'); dot != std::string_view::npos; dot = key.find('.', dot + 1)) {
+				if (dot + 1 < key.size()) visit(key.substr(0, dot + 1));
+			}
+		}
+
+	} // namespace
+
+	Config::SubscriptionId Config::subscribe(std::string_view pattern, ChangeCallback callback) {
+		if (!subscriptions_) subscriptions_ = std::make_unique<Subscriptions>();
+
+		SubscriptionId id = subscriptions_->next_id++;
+		subscriptions_->by_id.emplace(id, Subscriptions::Subscription{ std::string(pattern), std::move(callback) });
+
+		auto it = subscriptions_->by_pattern.find(pattern);
+		if (it == subscriptions_->by_pattern.end()) {
+			it = subscriptions_->by_pattern.emplace(std::string(pattern), std::vector<SubscriptionId>()).first;
+		}
+		it->second.push_back(id);
+		return id;
+	}
+
+	bool Config::unsubscribe(SubscriptionId id) {
+		if (!subscriptions_) return false;
+		auto it = subscriptions_->by_id.find(id);
+		if (it == subscriptions_->by_id.end()) return false;
+
+		auto pattern = subscriptions_->by_pattern.find(it->second.pattern);
+		auto& ids = pattern->second;
+		ids.erase(std::find(ids.begin(), ids.end(), id));
+		if (ids.empty()) subscriptions_->by_pattern.erase(pattern);
+
+		subscriptions_->by_id.erase(it);
+		return true;
+	}
+
+	void Config::notify_change(std::string_view key) {
+		if (!subscriptions_ || subscriptions_->by_pattern.empty()) return;
+
+		// Only queue keys someone is listening to
+		bool watched = false;
+		for_each_subscriber(subscriptions_->by_pattern, key, [&](SubscriptionId) { watched = true; });
+		if (!watched) return;
+
+		if (!subscriptions_->pending_set.contains(key)) {
+			subscriptions_->pending_set.emplace(key);
+			subscriptions_->pending.emplace_back(key);
+		}
+		if (batch_depth_ == 0) deliver_notifications();
+	}
+
+	void Config::deliver_notifications(bool contain_errors) {
+		if (!subscriptions_ || subscriptions_->pending.empty()) return;
+
+		// Take the queue first, callbacks may change the Config again
+		std::vector<std::string> keys = std::move(subscriptions_->pending);
+		subscriptions_->pending.clear();
+		subscriptions_->pending_set.clear();
+
+		// Ordered by id, so subscribers are called in subscription order
+		std::map<SubscriptionId, std::vector<std::string>> batches;
+		for (const auto& key : keys) {
+			for_each_subscriber(subscriptions_->by_pattern, key, [&](SubscriptionId id) {
+				batches[id].push_back(key);
+			});
+		}
+
+		for (const auto& [id, changed] : batches) {
+			// Earlier callbacks may have unsubscribed this one
+			auto it = subscriptions_->by_id.find(id);
+			if (it == subscriptions_->by_id.end()) continue;
+			ChangeCallback callback = it->second.callback;
+			if (!contain_errors) {
+				callback(changed);
+				continue;
+			}
+			try {
+				callback(changed);
+			}
+			catch (...) {
+				// Called from a destructor, nowhere to report it
+			}
+		}
+	}
+
+} // namespace bstk
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "bstk/config_view.hpp"
+
+namespace bstk {
+
+	ConfigView::ConfigView(const Config& parent, std::string_view prefix)
+		: parent_(&parent), prefix_(prefix) {
+		if (!prefix_.empty() && prefix_.back() != '.') prefix_ += '.';
+	}
+
+	const Value* ConfigView::get(std::string_view key) const {
+		// Compose the full key on the stack for the common case
+		char buffer[256];
+		size_t total = prefix_.size() + key.size();
+		if (total <= sizeof(buffer)) {
+			prefix_.copy(buffer, prefix_.size());
+			key.copy(buffer + prefix_.size(), key.size());
+			return parent_->get(std::string_view(buffer, total));
+		}
+		return parent_->get(prefix_ + std::string(key));
+	}
+
+	std::span<const Config::Entry* const> ConfigView::range() const {
+		auto range = parent_->prefix_range(prefix_);
+		// The bare prefix itself is not a member of the namespace
+		if (!range.empty() && range.front()->first.size() == prefix_.size()) {
+			range = range.subspan(1);
+		}
+		return range;
+	}
+
+	ConfigView::Iterator ConfigView::begin() const {
+		return Iterator(range().data(), prefix_.size());
+	}
+
+	ConfigView::Iterator ConfigView::end() const {
+		auto r = range();
+		return Iterator(r.data() + r.size(), prefix_.size());
+	}
+
+	size_t ConfigView::size() const {
+		return range().size();
+	}
+
+	ConfigView ConfigView::view(std::string_view sub_prefix) const {
+		return ConfigView(*parent_, prefix_ + std::string(sub_prefix));
+	}
+
+	Config ConfigView::to_config() const {
+		return parent_->get_namespace(prefix_);
+	}
+
+	ConfigView Config::view(std::string_view prefix) const {
+		return ConfigView(*this, prefix);
+	}
+
+	ConfigView Config::instance_view(std::string_view instance_name) const {
+		std::string prefix(instance_prefix);
+		prefix += instance_name;
+		return ConfigView(*this, prefix);
+	}
+
+} // namespace bstk
\ No newline at end of file
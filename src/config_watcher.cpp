@@ -0,0 +1,175 @@
+#include "bstk/config_watcher.hpp"
+#include "bstk/atomic_file.hpp"
+#include "bstk/mapped_file.hpp"
+#include <functional>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <climits>
+#endif
+
+namespace bstk {
+
+	ConfigWatcher::ConfigWatcher(Config& config, std::string filepath, std::chrono::milliseconds debounce)
+		: config_(config), filepath_(std::move(filepath)), debounce_(debounce) {
+		size_t slash = filepath_.find_last_of("/\\");
+		filename_ = slash == std::string::npos ? filepath_ : filepath_.substr(slash + 1);
+	}
+
+	ConfigWatcher::~ConfigWatcher() {
+		stop();
+	}
+
+	std::vector<std::string> ConfigWatcher::poll() {
+		if (drain_events()) {
+			pending_ = true;
+			last_event_ = Clock::now();
+		}
+		if (!pending_ || Clock::now() - last_event_ < debounce_) return {};
+		return reload();
+	}
+
+	std::vector<std::string> ConfigWatcher::wait(std::chrono::milliseconds timeout) {
+		// With a reload pending, wait no longer than its debounce deadline
+		if (pending_) {
+			auto remaining = std::chrono::ceil<std::chrono::milliseconds>(last_event_ + debounce_ - Clock::now());
+			if (remaining < timeout) timeout = remaining;
+		}
+		if (timeout.count() > 0) wait_for_event(timeout);
+		return poll();
+	}
+
+	std::vector<std::string> ConfigWatcher::reload() {
+		pending_ = false;
+		std::vector<std::string> changed;
+
+		// Writers may hold the file briefly, the next event retries
+		MappedFile file;
+		if (!file.open(filepath_)) return changed;
+
+		// Rewrites with identical content are common, skip them before parsing
+		size_t hash = std::hash<std::string_view>{}(file.view());
+		if (has_hash_ && hash == content_hash_) return changed;
+
+		if (config_.reload_from_string(file.view(), changed)) {
+			content_hash_ = hash;
+			has_hash_ = true;
+			++reload_count_;
+		}
+		return changed;
+	}
+
+#ifdef _WIN32
+
+	bool ConfigWatcher::start() {
+		stop();
+
+		// Notifications are per directory, the content hash filters other files
+		std::string directory = AtomicFile::parent_directory(filepath_);
+		HANDLE handle = FindFirstChangeNotificationA(directory.c_str(), FALSE,
+			FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE);
+		if (handle == INVALID_HANDLE_VALUE) return false;
+		handle_ = handle;
+
+		MappedFile file;
+		has_hash_ = file.open(filepath_);
+		if (has_hash_) content_hash_ = std::hash<std::string_view>{}(file.view());
+		return true;
+	}
+
+	void ConfigWatcher::stop() noexcept {
+		if (handle_) FindCloseChangeNotification(handle_);
+		handle_ = nullptr;
+		pending_ = false;
+	}
+
+	bool ConfigWatcher::is_watching() const noexcept {
+		return handle_ != nullptr;
+	}
+
+	bool ConfigWatcher::drain_events() {
+		if (!handle_) return false;
+		bool seen = false;
+		while (WaitForSingleObject(handle_, 0) == WAIT_OBJECT_0) {
+			seen = true;
+			if (!FindNextChangeNotification(handle_)) break;
+		}
+		return seen;
+	}
+
+	void ConfigWatcher::wait_for_event(std::chrono::milliseconds timeout) {
+		if (!handle_) return;
+		WaitForSingleObject(handle_, static_cast<DWORD>(timeout.count()));
+	}
+
+#else
+
+	bool ConfigWatcher::start() {
+		stop();
+
+		int fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (fd < 0) return false;
+
+		// Watch the directory so replace-by-rename is seen as well as in-place writes
+		std::string directory = AtomicFile::parent_directory(filepath_);
+		if (::inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE | IN_DELETE) < 0) {
+			::close(fd);
+			return false;
+		}
+		fd_ = fd;
+
+		MappedFile file;
+		has_hash_ = file.open(filepath_);
+		if (has_hash_) content_hash_ = std::hash<std::string_view>{}(file.view());
+		return true;
+	}
+
+	void ConfigWatcher::stop() noexcept {
+		if (fd_ >= 0) ::close(fd_);
+		fd_ = -1;
+		pending_ = false;
+	}
+
+	bool ConfigWatcher::is_watching() const noexcept {
+		return fd_ >= 0;
+	}
+
+	bool ConfigWatcher::drain_events() {
+		if (fd_ < 0) return false;
+
+		alignas(inotify_event) char buffer[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+		bool seen = false;
+		for (;;) {
+			ssize_t n = ::read(fd_, buffer, sizeof(buffer));
+			if (n <= 0) break;
+
+			for (char* p = buffer; p < buffer + n;) {
+				const auto* event = reinterpret_cast<const inotify_event*>(p);
+				if (event->len > 0 && filename_ == event->name) seen = true;
+				// Queue overflow drops events, assume the file was among them
+				if (event->mask & IN_Q_OVERFLOW) seen = true;
+				p += sizeof(inotify_event) + event->len;
+			}
+		}
+		return seen;
+	}
+
+	void ConfigWatcher::wait_for_event(std::chrono::milliseconds timeout) {
+		if (fd_ < 0) return;
+		pollfd pfd{ fd_, POLLIN, 0 };
+		::poll(&pfd, 1, static_cast<int>(timeout.count()));
+	}
+
+#endif
+
+} // namespace bstk
\ No newline at end of file
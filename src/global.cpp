@@ -157,6 +157,8 @@ namespace bstk {
 
 	void Global::save_to_config() {
 		auto& p = props_;
+		// A throwing save rolls the partial write back
+		Config::Batch batch(*config_);
 
 		// Identity
 		save_value("bst.bluestacks_account_id", p.identity.account_id);
@@ -273,6 +275,8 @@ namespace bstk {
 		save_value("bst.mim.batch_operation_interval", p.mim.batch_operation_interval);
 		save_value("bst.mim.delete_folder_warning", p.mim.delete_folder_warning);
 		save_value("bst.mim.delete_instance_in_folder_warning", p.mim.delete_instance_in_folder_warning);
+
+		batch.commit();
 	}
 
 	Value Global::get(std::string_view key) const {
@@ -321,7 +325,7 @@ namespace bstk {
 	}
 
 	bool Global::is_instance_key(std::string_view key) {
-		return key.size() > 14 && key.substr(0, 14) == "bst.instance.";
+		return Config::instance_name_of(key).has_value();
 	}
 
 	std::string Global::full_key(std::string_view key) const {
@@ -334,7 +338,7 @@ namespace bstk {
 
 	template<typename T>
 	void Global::load_value(std::string_view key, T& target, std::string_view category) {
-		if (auto val = config_->get(std::string(key))) {
+		if (auto val = config_->get(key)) {
 			if constexpr (std::is_same_v<T, std::string>) {
 				target = val->as_string();
 			}
@@ -353,16 +357,16 @@ namespace bstk {
 	template<typename T>
 	void Global::save_value(std::string_view key, const T& source) {
 		if constexpr (std::is_same_v<T, std::string>) {
-			config_->set_string(std::string(key), source);
+			config_->set_string(key, source);
 		}
 		else if constexpr (std::is_same_v<T, bool>) {
-			config_->set_bool(std::string(key), source);
+			config_->set_bool(key, source);
 		}
 		else if constexpr (std::is_integral_v<T>) {
-			config_->set_int(std::string(key), static_cast<int64_t>(source));
+			config_->set_int(key, static_cast<int64_t>(source));
 		}
 		else if constexpr (std::is_floating_point_v<T>) {
-			config_->set_double(std::string(key), static_cast<double>(source));
+			config_->set_double(key, static_cast<double>(source));
 		}
 	}
 
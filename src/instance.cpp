@@ -1,117 +1,131 @@
 #include "bstk/instance.hpp"
 #include "bstk/config.hpp"
+#include "bstk/config_view.hpp"
+#include <algorithm>
+#include <variant>
+#include <vector>
 
 namespace bstk {
 
+	namespace {
+
+		using Properties = Instance::Properties;
+
+		// Schema of the typed Properties fields, keyed by suffix after "bst.instance.<name>."
+		struct Field {
+			std::string_view key;
+			std::variant<std::string Properties::*, int Properties::*, bool Properties::*> member;
+		};
+
+		constexpr Field field_table[] = {
+			// Display
+			{ "display_name", &Properties::display_name },
+			{ "fb_width", &Properties::fb_width },
+			{ "fb_height", &Properties::fb_height },
+			{ "dpi", &Properties::dpi },
+			{ "max_fps", &Properties::max_fps },
+			{ "enable_high_fps", &Properties::enable_high_fps },
+			{ "enable_vsync", &Properties::enable_vsync },
+			{ "enable_fullscreen_all_apps", &Properties::enable_fullscreen_all_apps },
+
+			// Performance
+			{ "cpus", &Properties::cpus },
+			{ "ram", &Properties::ram },
+			{ "graphics_engine", &Properties::graphics_engine },
+			{ "graphics_renderer", &Properties::graphics_renderer },
+			{ "enable_fps_display", &Properties::enable_fps_display },
+			{ "eco_mode_max_fps", &Properties::eco_mode_max_fps },
+
+			// Features
+			{ "enable_root_access", &Properties::enable_root_access },
+			{ "enable_notifications", &Properties::enable_notifications },
+			{ "game_controls_enabled", &Properties::game_controls_enabled },
+			{ "show_sidebar", &Properties::show_sidebar },
+			{ "pin_to_top", &Properties::pin_to_top },
+
+			// Network
+			{ "adb_port", &Properties::adb_port },
+			{ "dns_server", &Properties::dns_server },
+			{ "airplane_mode_active", &Properties::airplane_mode_active },
+
+			// Device
+			{ "device_profile_code", &Properties::device_profile_code },
+			{ "device_carrier_code", &Properties::device_carrier_code },
+			{ "device_country_code", &Properties::device_country_code },
+
+			// Storage/Graphics
+			{ "abi_list", &Properties::abi_list },
+			{ "vulkan_supported", &Properties::vulkan_supported },
+			{ "astc_decoding_mode", &Properties::astc_decoding_mode },
+
+			// Audio
+			{ "android_sound_while_tapping", &Properties::android_sound_while_tapping },
+
+			// Identity
+			{ "android_id", &Properties::android_id },
+			{ "android_google_ad_id", &Properties::android_google_ad_id },
+			{ "google_account_logins", &Properties::google_account_logins }
+		};
+
+		const std::vector<const Field*>& sorted_fields() {
+			static const std::vector<const Field*> sorted = [] {
+				std::vector<const Field*> result;
+				for (const auto& field : field_table) result.push_back(&field);
+				std::sort(result.begin(), result.end(),
+					[](const Field* a, const Field* b) { return a->key < b->key; });
+				return result;
+			}();
+			return sorted;
+		}
+
+	} // namespace
+
 	Instance::Instance(Config& config, std::string name)
 		: config_(&config), name_(std::move(name)) {
 		load_from_config();
 	}
 
 	void Instance::load_from_config() {
-		auto& p = props_;
-		std::string prefix = key_prefix();
-
-		// Display
-		load_value("display_name", p.display_name);
-		load_value("fb_width", p.fb_width);
-		load_value("fb_height", p.fb_height);
-		load_value("dpi", p.dpi);
-		load_value("max_fps", p.max_fps);
-		load_value("enable_high_fps", p.enable_high_fps);
-		load_value("enable_vsync", p.enable_vsync);
-		load_value("enable_fullscreen_all_apps", p.enable_fullscreen_all_apps);
-
-		// Performance
-		load_value("cpus", p.cpus);
-		load_value("ram", p.ram);
-		load_value("graphics_engine", p.graphics_engine);
-		load_value("graphics_renderer", p.graphics_renderer);
-		load_value("enable_fps_display", p.enable_fps_display);
-		load_value("eco_mode_max_fps", p.eco_mode_max_fps);
-
-		// Features
-		load_value("enable_root_access", p.enable_root_access);
-		load_value("enable_notifications", p.enable_notifications);
-		load_value("game_controls_enabled", p.game_controls_enabled);
-		load_value("show_sidebar", p.show_sidebar);
-		load_value("pin_to_top", p.pin_to_top);
-
-		// Network
-		load_value("adb_port", p.adb_port);
-		load_value("dns_server", p.dns_server);
-		load_value("airplane_mode_active", p.airplane_mode_active);
-
-		// Device
-		load_value("device_profile_code", p.device_profile_code);
-		load_value("device_carrier_code", p.device_carrier_code);
-		load_value("device_country_code", p.device_country_code);
-
-		// Storage/Graphics
-		load_value("abi_list", p.abi_list);
-		load_value("vulkan_supported", p.vulkan_supported);
-		load_value("astc_decoding_mode", p.astc_decoding_mode);
-
-		// Audio
-		load_value("android_sound_while_tapping", p.android_sound_while_tapping);
-
-		// Identity
-		load_value("android_id", p.android_id);
-		load_value("android_google_ad_id", p.android_google_ad_id);
-		load_value("google_account_logins", p.google_account_logins);
+		// Merge-join this instance's key range (key order) against the field
+		// table (also key order): one pass, no key building, no hash probes
+		const auto& fields = sorted_fields();
+		auto field = fields.begin();
+
+		for (auto item : config_->instance_view(name_)) {
+			while (field != fields.end() && (*field)->key < item.key) ++field;
+			if (field == fields.end()) break;
+			if ((*field)->key != item.key) continue;
+
+			std::visit([&](auto member) {
+				auto& target = props_.*member;
+				target = item.value.as<std::remove_reference_t<decltype(target)>>();
+			}, (*field)->member);
+		}
 	}
 
 	void Instance::save_to_config() {
-		const auto& p = props_;
-		std::string prefix = key_prefix();
-
-		// Display
-		save_value("display_name", p.display_name);
-		save_value("fb_width", p.fb_width);
-		save_value("fb_height", p.fb_height);
-		save_value("dpi", p.dpi);
-		save_value("max_fps", p.max_fps);
-		save_value("enable_high_fps", p.enable_high_fps);
-		save_value("enable_vsync", p.enable_vsync);
-		save_value("enable_fullscreen_all_apps", p.enable_fullscreen_all_apps);
-
-		// Performance
-		save_value("cpus", p.cpus);
-		save_value("ram", p.ram);
-		save_value("graphics_engine", p.graphics_engine);
-		save_value("graphics_renderer", p.graphics_renderer);
-		save_value("enable_fps_display", p.enable_fps_display);
-		save_value("eco_mode_max_fps", p.eco_mode_max_fps);
-
-		// Features
-		save_value("enable_root_access", p.enable_root_access);
-		save_value("enable_notifications", p.enable_notifications);
-		save_value("game_controls_enabled", p.game_controls_enabled);
-		save_value("show_sidebar", p.show_sidebar);
-		save_value("pin_to_top", p.pin_to_top);
-
-		// Network
-		save_value("adb_port", p.adb_port);
-		save_value("dns_server", p.dns_server);
-		save_value("airplane_mode_active", p.airplane_mode_active);
-
-		// Device
-		save_value("device_profile_code", p.device_profile_code);
-		save_value("device_carrier_code", p.device_carrier_code);
-		save_value("device_country_code", p.device_country_code);
-
-		// Storage/Graphics
-		save_value("abi_list", p.abi_list);
-		save_value("vulkan_supported", p.vulkan_supported);
-		save_value("astc_decoding_mode", p.astc_decoding_mode);
-
-		// Audio
-		save_value("android_sound_while_tapping", p.android_sound_while_tapping);
-
-		// Identity
-		save_value("android_id", p.google_account_logins);
-		save_value("android_google_ad_id", p.android_google_ad_id);
-		save_value("google_account_logins", p.google_account_logins);
+		// Reuse one key buffer, only the suffix changes per field
+		std::string key = key_prefix();
+		const size_t prefix_size = key.size();
+
+		for (const auto& field : field_table) {
+			key.resize(prefix_size);
+			key += field.key;
+
+			std::visit([&](auto member) {
+				const auto& source = props_.*member;
+				using T = std::remove_cvref_t<decltype(source)>;
+				if constexpr (std::is_same_v<T, std::string>) {
+					config_->set_string(key, source);
+				}
+				else if constexpr (std::is_same_v<T, bool>) {
+					config_->set_bool(key, source);
+				}
+				else {
+					config_->set_int(key, static_cast<int64_t>(source));
+				}
+			}, field.member);
+		}
 	}
 
 	Value Instance::get(std::string_view key) const {
@@ -164,49 +178,4 @@ namespace bstk {
 		return key_prefix() + std::string(key);
 	}
 
-	template<typename T>
-	void Instance::load_value(std::string_view key, T& target) {
-		if (auto val = config_->get(full_key(key))) {
-			if constexpr (std::is_same_v<T, std::string>) {
-				target = val->as_string();
-			}
-			else if constexpr (std::is_same_v<T, bool>) {
-				target = val->as_bool();
-			}
-			else if constexpr (std::is_integral_v<T>) {
-				target = static_cast<T>(val->as_int());
-			}
-			else if constexpr (std::is_floating_point_v<T>) {
-				target = static_cast<T>(val->as_double());
-			}
-		}
-	}
-
-	template<typename T>
-	void Instance::save_value(std::string_view key, const T& source) {
-		if constexpr (std::is_same_v<T, std::string>) {
-			config_->set_string(full_key(key), source);
-		}
-		else if constexpr (std::is_same_v<T, bool>) {
-			config_->set_bool(full_key(key), source);
-		}
-		else if constexpr (std::is_integral_v<T>) {
-			config_->set_int(full_key(key), static_cast<int64_t>(source));
-		}
-		else if constexpr (std::is_floating_point_v<T>) {
-			config_->set_double(full_key(key), static_cast<double>(source));
-		}
-	}
-
-	// Explicit instantiations
-	template void Instance::load_value<std::string>(std::string_view, std::string&);
-	template void Instance::load_value<bool>(std::string_view, bool&);
-	template void Instance::load_value<int>(std::string_view, int&);
-	template void Instance::load_value<int64_t>(std::string_view, int64_t&);
-
-	template void Instance::save_value<std::string>(std::string_view, const std::string&);
-	template void Instance::save_value<bool>(std::string_view, const bool&);
-	template void Instance::save_value<int>(std::string_view, const int&);
-	template void Instance::save_value<int64_t>(std::string_view, const int64_t&);
-
 } // namespace bstk
\ No newline at end of file
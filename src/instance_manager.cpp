@@ -1,5 +1,7 @@
 #include "bstk/instance_manager.hpp"
 #include "bstk/config.hpp"
+#include <algorithm>
+#include <stdexcept>
 
 namespace bstk {
 
@@ -7,88 +9,138 @@ namespace bstk {
 		reload();
 	}
 
+	InstanceManager::InstanceManager(const InstanceManager& other)
+		: config_(other.config_), slots_(other.slots_), free_slots_(other.free_slots_), index_(other.index_) {
+		// Re-point the order at our own slots
+		order_.reserve(other.order_.size());
+		for (const Instance* inst : other.order_) {
+			order_.push_back(&*slots_[index_.find(inst->name())->second].instance);
+		}
+	}
+
+	InstanceManager& InstanceManager::operator=(const InstanceManager& other) {
+		if (this != &other) {
+			*this = InstanceManager(other);
+		}
+		return *this;
+	}
+
 	void InstanceManager::reload() {
-		instances_.clear();
+		release_all();
 		auto names = config_->get_instance_names();
-		for (const auto& name : names) {
-			instances_.emplace_back(*config_, name);
+		order_.reserve(names.size());
+		index_.reserve(names.size());
+		for (auto& name : names) {
+			create(std::move(name));
 		}
 	}
 
-	Instance* InstanceManager::get(std::string_view name) {
-		for (auto& inst : instances_) {
-			if (inst.name() == name) return &inst;
+	void InstanceManager::release_all() {
+		// Bump every live slot so outstanding handles go stale
+		for (Instance* inst : order_) {
+			uint32_t slot = index_.find(inst->name())->second;
+			slots_[slot].instance.reset();
+			++slots_[slot].generation;
+			free_slots_.push_back(slot);
 		}
-		return nullptr;
+		order_.clear();
+		index_.clear();
+	}
+
+	Instance* InstanceManager::get(std::string_view name) {
+		auto it = index_.find(name);
+		return it != index_.end() ? &*slots_[it->second].instance : nullptr;
 	}
 
 	const Instance* InstanceManager::get(std::string_view name) const {
-		for (const auto& inst : instances_) {
-			if (inst.name() == name) return &inst;
-		}
-		return nullptr;
+		auto it = index_.find(name);
+		return it != index_.end() ? &*slots_[it->second].instance : nullptr;
 	}
 
-	Instance* InstanceManager::find(std::function<bool(const Instance&)> pred) {
-		for (auto& inst : instances_) {
-			if (pred(inst)) return &inst;
-		}
-		return nullptr;
+	InstanceHandle InstanceManager::handle_of(std::string_view name) const {
+		auto it = index_.find(name);
+		if (it == index_.end()) return {};
+		return { it->second, slots_[it->second].generation };
 	}
 
-	std::vector<Instance*> InstanceManager::find_all(std::function<bool(const Instance&)> pred) {
-		std::vector<Instance*> result;
-		for (auto& inst : instances_) {
-			if (pred(inst)) result.push_back(&inst);
-		}
-		return result;
+	Instance* InstanceManager::get(InstanceHandle handle) {
+		if (handle.slot >= slots_.size()) return nullptr;
+		Slot& slot = slots_[handle.slot];
+		return (slot.generation == handle.generation && slot.instance) ? &*slot.instance : nullptr;
+	}
+
+	const Instance* InstanceManager::get(InstanceHandle handle) const {
+		if (handle.slot >= slots_.size()) return nullptr;
+		const Slot& slot = slots_[handle.slot];
+		return (slot.generation == handle.generation && slot.instance) ? &*slot.instance : nullptr;
 	}
 
 	Instance& InstanceManager::create(std::string name) {
 		if (has(name)) {
 			throw std::runtime_error("Instance already exists: " + name);
 		}
-		instances_.emplace_back(*config_, std::move(name));
-		return instances_.back();
+
+		uint32_t slot;
+		if (!free_slots_.empty()) {
+			slot = free_slots_.back();
+			free_slots_.pop_back();
+		}
+		else {
+			slot = static_cast<uint32_t>(slots_.size());
+			slots_.emplace_back();
+		}
+
+		Instance& inst = slots_[slot].instance.emplace(*config_, std::move(name));
+		index_.emplace(inst.name(), slot);
+		order_.push_back(&inst);
+		return inst;
 	}
 
 	bool InstanceManager::remove(std::string_view name) {
-		auto it = std::find_if(instances_.begin(), instances_.end(),
-			[name](const Instance& i) { return i.name() == name; });
-
-		if (it != instances_.end()) {
-			// Remove all keys from config
-			auto keys = config_->get_keys_with_prefix("bst.instance." + std::string(name) + ".");
-			for (const auto& key : keys) {
-				config_->remove(key);
-			}
-			instances_.erase(it);
-			return true;
+		auto it = index_.find(name);
+		if (it == index_.end()) return false;
+
+		// Remove all keys from config
+		auto keys = config_->get_keys_with_prefix("bst.instance." + std::string(name) + ".");
+		for (const auto& key : keys) {
+			config_->remove(key);
 		}
-		return false;
+
+		uint32_t slot = it->second;
+		Instance* inst = &*slots_[slot].instance;
+		order_.erase(std::find(order_.begin(), order_.end(), inst));
+		index_.erase(it);
+		slots_[slot].instance.reset();
+		++slots_[slot].generation;
+		free_slots_.push_back(slot);
+		return true;
 	}
 
 	bool InstanceManager::has(std::string_view name) const {
-		return get(name) != nullptr;
+		return index_.contains(name);
 	}
 
 	void InstanceManager::save_all() {
-		for (auto& inst : instances_) {
-			inst.save_to_config();
+		// One batch: a single index rebuild and one round of notifications,
+		// all or nothing if an instance fails to save
+		Config::Batch batch(*config_);
+		for (Instance* inst : order_) {
+			inst->save_to_config();
 		}
+		batch.commit();
 	}
 
 	void InstanceManager::apply_to_all(std::function<void(Instance&)> func) {
-		for (auto& inst : instances_) {
-			func(inst);
+		for (Instance* inst : order_) {
+			func(*inst);
 		}
 	}
 
 	std::vector<std::reference_wrapper<Instance>> InstanceManager::with_root_access() {
 		std::vector<std::reference_wrapper<Instance>> result;
-		for (auto& inst : instances_) {
-			if (inst.props().enable_root_access) {
-				result.push_back(std::ref(inst));
+		for (Instance* inst : order_) {
+			if (inst->props().enable_root_access) {
+				result.push_back(std::ref(*inst));
 			}
 		}
 		return result;
@@ -96,9 +148,9 @@ namespace bstk {
 
 	std::vector<std::reference_wrapper<Instance>> InstanceManager::with_high_fps() {
 		std::vector<std::reference_wrapper<Instance>> result;
-		for (auto& inst : instances_) {
-			if (inst.props().enable_high_fps) {
-				result.push_back(std::ref(inst));
+		for (Instance* inst : order_) {
+			if (inst->props().enable_high_fps) {
+				result.push_back(std::ref(*inst));
 			}
 		}
 		return result;
@@ -106,9 +158,9 @@ namespace bstk {
 
 	std::vector<std::reference_wrapper<Instance>> InstanceManager::matching_resolution(int width, int height) {
 		std::vector<std::reference_wrapper<Instance>> result;
-		for (auto& inst : instances_) {
-			if (inst.props().fb_width == width && inst.props().fb_height == height) {
-				result.push_back(std::ref(inst));
+		for (Instance* inst : order_) {
+			if (inst->props().fb_width == width && inst->props().fb_height == height) {
+				result.push_back(std::ref(*inst));
 			}
 		}
 		return result;
@@ -0,0 +1,155 @@
+#include "bstk/instance_table.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace bstk {
+
+	namespace {
+
+		using Properties = Instance::Properties;
+
+		// Property behind each column and flag, in enum order
+		constexpr int Properties::* column_members[] = {
+			&Properties::fb_width,
+			&Properties::fb_height,
+			&Properties::dpi,
+			&Properties::max_fps,
+			&Properties::cpus,
+			&Properties::ram,
+			&Properties::adb_port,
+		};
+
+		constexpr bool Properties::* flag_members[] = {
+			&Properties::enable_high_fps,
+			&Properties::enable_vsync,
+			&Properties::enable_fullscreen_all_apps,
+			&Properties::enable_fps_display,
+			&Properties::enable_root_access,
+			&Properties::enable_notifications,
+			&Properties::game_controls_enabled,
+			&Properties::show_sidebar,
+			&Properties::pin_to_top,
+			&Properties::airplane_mode_active,
+			&Properties::vulkan_supported,
+			&Properties::android_sound_while_tapping,
+		};
+
+		static_assert(std::size(column_members) == static_cast<size_t>(InstanceTable::Column::Count));
+		static_assert(std::size(flag_members) == static_cast<size_t>(InstanceTable::Flag::Count));
+
+	} // namespace
+
+	void InstanceTable::append(const InstanceManager& mgr) {
+		reserve(size() + mgr.count());
+		for (const Instance& instance : mgr) append(instance);
+	}
+
+	void InstanceTable::append(const Instance& instance) {
+		const Properties& props = instance.props();
+		size_t row = names_.size();
+		names_.push_back(instance.name());
+
+		for (size_t c = 0; c < std::size(column_members); ++c) {
+			columns_[c].push_back(static_cast<int32_t>(props.*column_members[c]));
+		}
+		for (size_t f = 0; f < std::size(flag_members); ++f) {
+			if (row % 64 == 0) flags_[f].push_back(0);
+			if (props.*flag_members[f]) flags_[f].back() |= uint64_t{ 1 } << (row % 64);
+		}
+	}
+
+	void InstanceTable::clear() noexcept {
+		names_.clear();
+		for (auto& column : columns_) column.clear();
+		for (auto& bits : flags_) bits.clear();
+	}
+
+	void InstanceTable::reserve(size_t rows) {
+		names_.reserve(rows);
+		for (auto& column : columns_) column.reserve(rows);
+		for (auto& bits : flags_) bits.reserve((rows + 63) / 64);
+	}
+
+	template<typename Pred>
+	InstanceTable::Bitset InstanceTable::scan(Column c, Pred pred) const {
+		const auto& column = columns_[static_cast<size_t>(c)];
+		const size_t rows = column.size();
+		Bitset mask((rows + 63) / 64, 0);
+
+		// Branch-free inner loop over 64 rows per output word
+		for (size_t w = 0; w < mask.size(); ++w) {
+			const int32_t* block = column.data() + w * 64;
+			const size_t n = std::min<size_t>(64, rows - w * 64);
+			uint64_t bits = 0;
+			for (size_t i = 0; i < n; ++i) {
+				bits |= static_cast<uint64_t>(pred(block[i])) << i;
+			}
+			mask[w] = bits;
+		}
+		return mask;
+	}
+
+	InstanceTable::IndexList InstanceTable::to_indices(const Bitset& mask) {
+		IndexList result;
+		size_t total = 0;
+		for (uint64_t word : mask) total += static_cast<size_t>(std::popcount(word));
+		result.reserve(total);
+
+		for (size_t w = 0; w < mask.size(); ++w) {
+			for (uint64_t bits = mask[w]; bits; bits &= bits - 1) {
+				result.push_back(static_cast<Index>(w * 64 + static_cast<size_t>(std::countr_zero(bits))));
+			}
+		}
+		return result;
+	}
+
+	InstanceTable::IndexList InstanceTable::with_flag(Flag f) const {
+		return to_indices(flags_[static_cast<size_t>(f)]);
+	}
+
+	InstanceTable::IndexList InstanceTable::where_equal(Column c, int32_t value) const {
+		return to_indices(scan(c, [value](int32_t v) { return v == value; }));
+	}
+
+	InstanceTable::IndexList InstanceTable::where_at_least(Column c, int32_t value) const {
+		return to_indices(scan(c, [value](int32_t v) { return v >= value; }));
+	}
+
+	InstanceTable::IndexList InstanceTable::where_between(Column c, int32_t low, int32_t high) const {
+		return to_indices(scan(c, [low, high](int32_t v) { return v >= low && v <= high; }));
+	}
+
+	InstanceTable::IndexList InstanceTable::matching_resolution(int32_t width, int32_t height) const {
+		Bitset mask = scan(Column::FbWidth, [width](int32_t v) { return v == width; });
+		Bitset heights = scan(Column::FbHeight, [height](int32_t v) { return v == height; });
+		for (size_t w = 0; w < mask.size(); ++w) mask[w] &= heights[w];
+		return to_indices(mask);
+	}
+
+	InstanceTable::IndexList InstanceTable::intersect(const IndexList& a, const IndexList& b) {
+		IndexList result;
+		result.reserve(std::min(a.size(), b.size()));
+		std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+		return result;
+	}
+
+	int64_t InstanceTable::sum(Column c) const {
+		int64_t total = 0;
+		for (int32_t v : columns_[static_cast<size_t>(c)]) total += v;
+		return total;
+	}
+
+	int64_t InstanceTable::sum(Column c, const IndexList& rows) const {
+		const auto& column = columns_[static_cast<size_t>(c)];
+		int64_t total = 0;
+		for (Index row : rows) total += column[row];
+		return total;
+	}
+
+	size_t InstanceTable::count(Flag f) const {
+		size_t total = 0;
+		for (uint64_t word : flags_[static_cast<size_t>(f)]) total += static_cast<size_t>(std::popcount(word));
+		return total;
+	}
+
+} // namespace bstk
\ No newline at end of file
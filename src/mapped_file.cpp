@@ -0,0 +1,210 @@
+#include "bstk/mapped_file.hpp"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bstk {
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept {
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+		if (this != &other) {
+			close();
+			data_ = std::exchange(other.data_, nullptr);
+			size_ = std::exchange(other.size_, 0);
+			open_ = std::exchange(other.open_, false);
+			buffer_ = std::move(other.buffer_);
+			capacity_ = std::exchange(other.capacity_, 0);
+			error_ = std::exchange(other.error_, {});
+#ifdef _WIN32
+			file_ = std::exchange(other.file_, nullptr);
+			mapping_ = std::exchange(other.mapping_, nullptr);
+#endif
+		}
+		return *this;
+	}
+
+	void MappedFile::grow_buffer(size_t used) {
+		size_t capacity = std::max<size_t>(capacity_ * 2, 64 * 1024);
+		std::unique_ptr<char[]> bigger(new char[capacity]);
+		if (used) std::memcpy(bigger.get(), buffer_.get(), used);
+		buffer_ = std::move(bigger);
+		capacity_ = capacity;
+	}
+
+	bool MappedFile::fail(int code) noexcept {
+		close();
+		error_.assign(code, std::system_category());
+		return false;
+	}
+
+#ifdef _WIN32
+
+	bool MappedFile::open(const std::string& filepath) {
+		close();
+
+		HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return fail(static_cast<int>(GetLastError()));
+
+		// Pipes and character devices cannot be mapped, read them to the end
+		if (GetFileType(file) != FILE_TYPE_DISK) {
+			size_t size = 0;
+			DWORD got = 0;
+			BOOL ok;
+			for (;;) {
+				if (size == capacity_) grow_buffer(size);
+				DWORD chunk = static_cast<DWORD>(std::min<size_t>(capacity_ - size, 1u << 30));
+				ok = ReadFile(file, buffer_.get() + size, chunk, &got, nullptr);
+				if (!ok || got == 0) break;
+				size += got;
+			}
+			// A pipe reports its end as ERROR_BROKEN_PIPE
+			DWORD error = ok ? ERROR_SUCCESS : GetLastError();
+			CloseHandle(file);
+			if (error != ERROR_SUCCESS && error != ERROR_BROKEN_PIPE) return fail(static_cast<int>(error));
+			data_ = buffer_.get();
+			size_ = size;
+			open_ = true;
+			return true;
+		}
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size)) {
+			DWORD error = GetLastError();
+			CloseHandle(file);
+			return fail(static_cast<int>(error));
+		}
+
+		// Zero-length files cannot be mapped
+		if (size.QuadPart == 0) {
+			CloseHandle(file);
+			open_ = true;
+			return true;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping) {
+			DWORD error = GetLastError();
+			CloseHandle(file);
+			return fail(static_cast<int>(error));
+		}
+
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!view) {
+			DWORD error = GetLastError();
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return fail(static_cast<int>(error));
+		}
+
+		file_ = file;
+		mapping_ = mapping;
+		data_ = static_cast<const char*>(view);
+		size_ = static_cast<size_t>(size.QuadPart);
+		open_ = true;
+		return true;
+	}
+
+	void MappedFile::close() noexcept {
+		if (mapping_) UnmapViewOfFile(data_);
+		if (mapping_) CloseHandle(mapping_);
+		if (file_) CloseHandle(file_);
+		data_ = nullptr;
+		mapping_ = nullptr;
+		file_ = nullptr;
+		size_ = 0;
+		open_ = false;
+		buffer_.reset();
+		capacity_ = 0;
+		error_.clear();
+	}
+
+#else
+
+	bool MappedFile::open(const std::string& filepath) {
+		close();
+
+		int fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0) return fail(errno);
+
+		struct stat st {};
+		if (::fstat(fd, &st) != 0) {
+			int error = errno;
+			::close(fd);
+			return fail(error);
+		}
+
+		// Map exactly the size fstat reports. procfs files report 0 and
+		// pipes have no size, those are read below instead.
+		if (S_ISREG(st.st_mode) && st.st_size > 0) {
+			size_t size = static_cast<size_t>(st.st_size);
+			void* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (view != MAP_FAILED) {
+				::close(fd); // The mapping keeps its own reference
+
+				// Parsing is a single forward pass
+				::madvise(view, size, MADV_SEQUENTIAL);
+
+				data_ = static_cast<const char*>(view);
+				size_ = size;
+				open_ = true;
+				return true;
+			}
+		}
+
+		size_t size = 0;
+		for (;;) {
+			if (size == capacity_) grow_buffer(size);
+			ssize_t got = ::read(fd, buffer_.get() + size, capacity_ - size);
+			if (got > 0) {
+				size += static_cast<size_t>(got);
+			}
+			else if (got == 0) {
+				break;
+			}
+			else if (errno != EINTR) {
+				int error = errno;
+				::close(fd);
+				return fail(error);
+			}
+		}
+		::close(fd);
+
+		data_ = buffer_.get();
+		size_ = size;
+		open_ = true;
+		return true;
+	}
+
+	void MappedFile::close() noexcept {
+		if (data_ && !buffer_) ::munmap(const_cast<char*>(data_), size_);
+		buffer_.reset();
+		capacity_ = 0;
+		data_ = nullptr;
+		size_ = 0;
+		open_ = false;
+		error_.clear();
+	}
+
+#endif
+
+} // namespace bstk
\ No newline at end of file
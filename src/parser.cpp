@@ -6,6 +6,15 @@
 namespace bstk {
 
 	std::optional<ParsedLine> Parser::parse_line(std::string_view line) {
+		auto span = split_line(line);
+		if (!span) {
+			return std::nullopt;
+		}
+
+		return ParsedLine{ std::string(span->key), unquote(span->value), true };
+	}
+
+	std::optional<LineSpan> Parser::split_line(std::string_view line) {
 		line = trim(line);
 
 		// Skip empty lines and comments
@@ -19,40 +28,45 @@ namespace bstk {
 			return std::nullopt;
 		}
 
-		std::string key = std::string(trim(line.substr(0, eq_pos)));
-		std::string_view value_view = trim(line.substr(eq_pos + 1));
+		return LineSpan{ trim(line.substr(0, eq_pos)), trim(line.substr(eq_pos + 1)) };
+	}
 
+	Value Parser::parse_value(std::string_view raw_value) {
+		return infer_value(unquote(raw_value));
+	}
+
+	std::string Parser::unquote(std::string_view value_view) {
 		// Remove quotes if present
-		std::string value;
 		if (value_view.size() >= 2 && value_view.front() == '"' && value_view.back() == '"') {
-			value = unescape(value_view.substr(1, value_view.size() - 2));
-		}
-		else {
-			value = std::string(value_view);
+			return unescape(value_view.substr(1, value_view.size() - 2));
 		}
-
-		return ParsedLine{ std::move(key), std::move(value), true };
+		return std::string(value_view);
 	}
 
 	std::string Parser::unescape(std::string_view value) {
 		std::string result;
 		result.reserve(value.size());
 
-		for (size_t i = 0; i < value.size(); ++i) {
-			if (value[i] == '\\' && i + 1 < value.size()) {
-				char next = value[i + 1];
-				switch (next) {
-				case '"': result += '"'; ++i; break;
-				case '\\': result += '\\'; ++i; break;
-				case 'n': result += '\n'; ++i; break;
-				case 'r': result += '\r'; ++i; break;
-				case 't': result += '\t'; ++i; break;
-				default: result += value[i]; break;
-				}
+		// Copy unescaped runs in bulk, decode one escape at a time
+		size_t i = 0;
+		while (i < value.size()) {
+			size_t bs = value.find('\\', i);
+			if (bs == std::string_view::npos || bs + 1 >= value.size()) {
+				result.append(value.data() + i, value.size() - i);
+				break;
 			}
-			else {
-				result += value[i];
+			result.append(value.data() + i, bs - i);
+
+			char next = value[bs + 1];
+			switch (next) {
+			case '"': result += '"'; break;
+			case '\\': result += '\\'; break;
+			case 'n': result += '\n'; break;
+			case 'r': result += '\r'; break;
+			case 't': result += '\t'; break;
+			default: result += '\\'; i = bs + 1; continue;
 			}
+			i = bs + 2;
 		}
 
 		return result;
@@ -85,19 +99,28 @@ namespace bstk {
 			std::from_chars(raw_value.data(), raw_value.data() + raw_value.size(), val);
 			return Value(val);
 		}
-		if (looks_like_double(raw_value)) {
-			return Value(std::stod(std::string(raw_value)));
+		double val = 0;
+		// Out of range (e.g. hand-written digits past 1e308) stays text
+		if (looks_like_double(raw_value) && parse_double(raw_value, val)) {
+			return Value(val);
 		}
-		return Value(std::string(raw_value));
+		return Value(raw_value);
+	}
+
+	bool Parser::parse_double(std::string_view text, double& out) noexcept {
+		// from_chars takes no leading '+'
+		if (!text.empty() && text[0] == '+') text.remove_prefix(1);
+		auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+		return ec == std::errc() && ptr == text.data() + text.size();
 	}
 
 	std::string_view Parser::trim(std::string_view sv) {
 		size_t start = 0;
-		while (start < sv.size() && std::isspace(static_cast<unsigned char>(sv[start]))) {
+		while (start < sv.size() && is_space(sv[start])) {
 			++start;
 		}
 		size_t end = sv.size();
-		while (end > start && std::isspace(static_cast<unsigned char>(sv[end - 1]))) {
+		while (end > start && is_space(sv[end - 1])) {
 			--end;
 		}
 		return sv.substr(start, end - start);
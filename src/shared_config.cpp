@@ -0,0 +1,131 @@
+#include "bstk/shared_config.hpp"
+
+namespace bstk {
+
+	namespace {
+
+		const std::shared_ptr<const Config::Map>& empty_shard() {
+			static const std::shared_ptr<const Config::Map> empty = std::make_shared<const Config::Map>();
+			return empty;
+		}
+
+	} // namespace
+
+	ConfigSnapshot::ConfigSnapshot() {
+		shards_.fill(empty_shard());
+	}
+
+	const Value* ConfigSnapshot::get(std::string_view key) const {
+		const Config::Map& shard = *shards_[shard_of(key)];
+		auto it = shard.find(key);
+		return it != shard.end() ? &it->second : nullptr;
+	}
+
+	void ConfigSnapshot::for_each(const std::function<void(const std::string&, const Value&)>& fn) const {
+		for (const auto& shard : shards_) {
+			for (const auto& [key, value] : *shard) fn(key, value);
+		}
+	}
+
+	Config ConfigSnapshot::to_config() const {
+		Config config;
+		for_each([&config](const std::string& key, const Value& value) {
+			config.set(key, value);
+		});
+		config.mark_clean();
+		return config;
+	}
+
+	Config::Map& SharedConfig::Editor::writable(size_t shard) {
+		if (!copied_[shard]) {
+			next_.shards_[shard] = std::make_shared<const Config::Map>(*next_.shards_[shard]);
+			copied_[shard] = true;
+		}
+		// Only this editor can see the fresh copy until it is published
+		return const_cast<Config::Map&>(*next_.shards_[shard]);
+	}
+
+	void SharedConfig::Editor::set(std::string_view key, Value value) {
+		// Readers on other threads must never trigger lazy resolution
+		value.resolve();
+
+		const Value* existing = get(key);
+		if (existing && *existing == value) return;
+
+		Config::Map& shard = writable(ConfigSnapshot::shard_of(key));
+		auto it = shard.find(key);
+		if (it != shard.end()) {
+			it->second = std::move(value);
+		}
+		else {
+			shard.emplace(std::string(key), std::move(value));
+			++next_.size_;
+		}
+		changed_ = true;
+	}
+
+	bool SharedConfig::Editor::remove(std::string_view key) {
+		if (!get(key)) return false;
+
+		Config::Map& shard = writable(ConfigSnapshot::shard_of(key));
+		shard.erase(shard.find(key));
+		--next_.size_;
+		changed_ = true;
+		return true;
+	}
+
+	const Value* SharedConfig::Editor::get(std::string_view key) const {
+		return next_.get(key);
+	}
+
+	SharedConfig::SharedConfig() {
+		current_.store(std::make_shared<const ConfigSnapshot>(), std::memory_order_release);
+	}
+
+	SharedConfig::SharedConfig(const Config& config) : SharedConfig() {
+		assign(config);
+	}
+
+	bool SharedConfig::update(const std::function<void(Editor&)>& edit) {
+		std::lock_guard<std::mutex> lock(write_mutex_);
+
+		// Start from the current shards, edits copy the ones they touch
+		auto next = std::make_shared<ConfigSnapshot>(*current_.load(std::memory_order_acquire));
+		Editor editor(*next);
+		edit(editor);
+		if (!editor.changed_) return false;
+
+		uint64_t version = ++next->version_;
+		current_.store(std::move(next), std::memory_order_release);
+		version_.store(version, std::memory_order_release);
+		return true;
+	}
+
+	void SharedConfig::set(std::string_view key, Value value) {
+		update([&](Editor& editor) { editor.set(key, std::move(value)); });
+	}
+
+	bool SharedConfig::remove(std::string_view key) {
+		return update([&](Editor& editor) { editor.remove(key); });
+	}
+
+	void SharedConfig::assign(const Config& config) {
+		// Bucket by shard first so each shard map is built once
+		std::array<Config::Map, ConfigSnapshot::shard_count> maps;
+		for (const auto& [key, value] : config) {
+			value.resolve();
+			maps[ConfigSnapshot::shard_of(key)].emplace(key, value);
+		}
+
+		std::lock_guard<std::mutex> lock(write_mutex_);
+		auto next = std::make_shared<ConfigSnapshot>();
+		for (size_t i = 0; i < ConfigSnapshot::shard_count; ++i) {
+			next->shards_[i] = maps[i].empty() ? empty_shard() : std::make_shared<const Config::Map>(std::move(maps[i]));
+		}
+		next->size_ = config.size();
+		uint64_t version = next->version_ = current_.load(std::memory_order_acquire)->version_ + 1;
+		current_.store(std::move(next), std::memory_order_release);
+		version_.store(version, std::memory_order_release);
+	}
+
+} // namespace bstk
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "bstk/stream_parser.hpp"
+#include "bstk/config.hpp"
+#include "bstk/parser.hpp"
+#include "bstk/tokenizer.hpp"
+#include <vector>
+
+namespace bstk {
+
+	ConfigStreamParser::ConfigStreamParser(Callback on_entry)
+		: callback_(std::move(on_entry)) {
+	}
+
+	ConfigStreamParser::ConfigStreamParser(Config& target)
+		: target_(&target), lazy_values_(target.lazy_values()) {
+	}
+
+	void ConfigStreamParser::feed(std::string_view chunk) {
+		// Complete the line carried over from the previous chunk
+		if (!carry_.empty()) {
+			size_t nl = chunk.find('\n');
+			if (nl == std::string_view::npos) {
+				carry_.append(chunk);
+				return;
+			}
+			carry_.append(chunk.substr(0, nl + 1));
+			parse_lines(carry_);
+			carry_.clear();
+			chunk.remove_prefix(nl + 1);
+		}
+
+		size_t last_nl = chunk.rfind('\n');
+		if (last_nl == std::string_view::npos) {
+			carry_.assign(chunk);
+			return;
+		}
+		parse_lines(chunk.substr(0, last_nl + 1));
+		carry_.assign(chunk.substr(last_nl + 1));
+	}
+
+	bool ConfigStreamParser::feed(std::istream& in, size_t chunk_size) {
+		std::vector<char> buffer(chunk_size);
+		while (in) {
+			in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			std::streamsize got = in.gcount();
+			if (got <= 0) break;
+			feed(std::string_view(buffer.data(), static_cast<size_t>(got)));
+		}
+		return in.eof();
+	}
+
+	void ConfigStreamParser::finish() {
+		if (carry_.empty()) return;
+		parse_lines(carry_);
+		carry_.clear();
+	}
+
+	void ConfigStreamParser::parse_lines(std::string_view lines) {
+		Tokenizer tokenizer(lines);
+		LineSpan span;
+		while (tokenizer.next(span)) {
+			++entries_;
+			if (target_) {
+				target_->insert_parsed(span.key, target_->make_parsed_value(span.value));
+			}
+			else if (callback_) {
+				callback_(span.key, lazy_values_ ? Value::lazy(span.value) : Parser::parse_value(span.value));
+			}
+		}
+	}
+
+} // namespace bstk
\ No newline at end of file
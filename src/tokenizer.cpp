@@ -0,0 +1,200 @@
+#include "bstk/tokenizer.hpp"
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BSTK_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(BSTK_X86) && (defined(__GNUC__) || defined(__clang__))
+#define BSTK_TARGET(isa) __attribute__((target(isa)))
+#else
+#define BSTK_TARGET(isa)
+#endif
+
+namespace bstk {
+
+	namespace {
+
+		constexpr size_t block_size = 64;
+
+		// Bit i is set when p[i] is '\n' or '='
+		using ClassifyFn = uint64_t(*)(const char* p);
+
+		uint64_t classify_scalar(const char* p) {
+			uint64_t mask = 0;
+			for (size_t i = 0; i < block_size; ++i) {
+				if (p[i] == '\n' || p[i] == '=') mask |= uint64_t{ 1 } << i;
+			}
+			return mask;
+		}
+
+#ifdef BSTK_X86
+		BSTK_TARGET("sse2")
+		uint64_t classify_sse2(const char* p) {
+			const __m128i nl = _mm_set1_epi8('\n');
+			const __m128i eq = _mm_set1_epi8('=');
+			uint64_t mask = 0;
+			for (int i = 0; i < 4; ++i) {
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 16));
+				__m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, nl), _mm_cmpeq_epi8(v, eq));
+				mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(hit))) << (i * 16);
+			}
+			return mask;
+		}
+
+		BSTK_TARGET("avx2")
+		uint64_t classify_avx2(const char* p) {
+			const __m256i nl = _mm256_set1_epi8('\n');
+			const __m256i eq = _mm256_set1_epi8('=');
+			__m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+			__m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+			__m256i hit_lo = _mm256_or_si256(_mm256_cmpeq_epi8(lo, nl), _mm256_cmpeq_epi8(lo, eq));
+			__m256i hit_hi = _mm256_or_si256(_mm256_cmpeq_epi8(hi, nl), _mm256_cmpeq_epi8(hi, eq));
+			return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hit_lo))) |
+				(static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hit_hi))) << 32);
+		}
+
+		bool cpu_has_avx2() {
+#ifdef _MSC_VER
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7) return false;
+			__cpuid(info, 1);
+			bool osxsave = (info[2] & (1 << 27)) != 0;
+			bool avx = (info[2] & (1 << 28)) != 0;
+			if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+#else
+			return __builtin_cpu_supports("avx2");
+#endif
+		}
+
+		bool cpu_has_sse2() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(_MSC_VER)
+			return true;
+#else
+			return __builtin_cpu_supports("sse2");
+#endif
+		}
+#endif
+
+		struct KernelEntry {
+			ClassifyFn fn;
+			const char* name;
+		};
+
+		// nullptr if this build or CPU cannot run it
+		const KernelEntry* find_kernel(Tokenizer::Kernel kernel) {
+			static const KernelEntry scalar{ classify_scalar, "scalar" };
+#ifdef BSTK_X86
+			static const KernelEntry sse2{ classify_sse2, "sse2" };
+			static const KernelEntry avx2{ classify_avx2, "avx2" };
+			static const bool has_sse2 = cpu_has_sse2();
+			static const bool has_avx2 = cpu_has_avx2();
+#endif
+			switch (kernel) {
+			case Tokenizer::Kernel::Scalar: return &scalar;
+#ifdef BSTK_X86
+			case Tokenizer::Kernel::Sse2: return has_sse2 ? &sse2 : nullptr;
+			case Tokenizer::Kernel::Avx2: return has_avx2 ? &avx2 : nullptr;
+#endif
+			case Tokenizer::Kernel::Auto: {
+				static const KernelEntry* selected = [] {
+					for (auto k : { Tokenizer::Kernel::Avx2, Tokenizer::Kernel::Sse2 }) {
+						if (const KernelEntry* entry = find_kernel(k)) return entry;
+					}
+					return &scalar;
+				}();
+				return selected;
+			}
+			default: return nullptr;
+			}
+		}
+
+		// Unsupported requests fall back to the automatic choice
+		ClassifyFn classifier_for(Tokenizer::Kernel kernel) {
+			const KernelEntry* entry = find_kernel(kernel);
+			return (entry ? entry : find_kernel(Tokenizer::Kernel::Auto))->fn;
+		}
+
+		// Build the span for one line, false for comment lines
+		bool make_span(const char* line, const char* eq, const char* line_end, LineSpan& out) {
+			while (line < eq && Parser::is_space(*line)) ++line;
+			if (line < eq && *line == '#') return false;
+
+			out.key = Parser::trim(std::string_view(line, static_cast<size_t>(eq - line)));
+			out.value = Parser::trim(std::string_view(eq + 1, static_cast<size_t>(line_end - eq - 1)));
+			return true;
+		}
+
+	} // namespace
+
+	Tokenizer::Tokenizer(std::string_view content, Kernel kernel) noexcept
+		: classify_(classifier_for(kernel)),
+		end_(content.data() + content.size()),
+		next_block_(content.data()),
+		block_(content.data()),
+		line_start_(content.data()) {
+	}
+
+	const char* Tokenizer::kernel_name() noexcept {
+		return find_kernel(Kernel::Auto)->name;
+	}
+
+	bool Tokenizer::supported(Kernel kernel) noexcept {
+		return find_kernel(kernel) != nullptr;
+	}
+
+	void Tokenizer::load_block() {
+		block_ = next_block_;
+		size_t remaining = static_cast<size_t>(end_ - block_);
+		if (remaining >= block_size) {
+			mask_ = classify_(block_);
+			next_block_ = block_ + block_size;
+			return;
+		}
+
+		// Pad the tail so the kernel never reads past the input
+		char tail[block_size] = {};
+		std::memcpy(tail, block_, remaining);
+		mask_ = classify_(tail) & ((uint64_t{ 1 } << remaining) - 1);
+		next_block_ = end_;
+	}
+
+	bool Tokenizer::next(LineSpan& out) {
+		for (;;) {
+			while (mask_ == 0) {
+				if (next_block_ >= end_) {
+					// Final line without a trailing newline
+					const char* line = line_start_;
+					const char* eq = eq_;
+					line_start_ = end_;
+					eq_ = nullptr;
+					return eq && make_span(line, eq, end_, out);
+				}
+				load_block();
+			}
+
+			const char* p = block_ + std::countr_zero(mask_);
+			mask_ &= mask_ - 1;
+
+			if (*p == '=') {
+				if (!eq_) eq_ = p;
+				continue;
+			}
+
+			const char* line = line_start_;
+			const char* eq = eq_;
+			line_start_ = p + 1;
+			eq_ = nullptr;
+			if (eq && make_span(line, eq, p, out)) return true;
+		}
+	}
+
+} // namespace bstk
\ No newline at end of file
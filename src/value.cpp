@@ -1,87 +1,229 @@
 #include "bstk/value.hpp"
+#include "bstk/parser.hpp"
 #include <charconv>
+#include <cmath>
+#include <limits>
 #include <sstream>
 
 namespace bstk {
 
-	std::string Value::as_string() const {
-		return std::visit([](auto&& arg) -> std::string {
-			using T = std::decay_t<decltype(arg)>;
-			if constexpr (std::is_same_v<T, std::string>) {
-				return arg;
-			}
-			else if constexpr (std::is_same_v<T, bool>) {
-				return arg ? "1" : "0";
-			}
-			else {
-				return std::to_string(arg);
+	namespace {
+
+		// Fits any int64 and the longest shortest-fixed double (denormals)
+		constexpr size_t number_chars = 512;
+
+		std::string_view format_int(int64_t val, char* buf) {
+			auto result = std::to_chars(buf, buf + number_chars, val);
+			return { buf, static_cast<size_t>(result.ptr - buf) };
+		}
+
+		// Shortest text that round-trips; fixed notation because the parser has
+		// no exponent form, and a ".0" suffix so whole numbers read back as doubles
+		std::string_view format_double(double val, char* buf) {
+			auto result = std::to_chars(buf, buf + number_chars - 2, val, std::chars_format::fixed);
+			std::string_view text(buf, static_cast<size_t>(result.ptr - buf));
+			if (std::isfinite(val) && text.find('.') == std::string_view::npos) {
+				*result.ptr++ = '.';
+				*result.ptr++ = '0';
+				text = { buf, text.size() + 2 };
 			}
-			}, data_);
+			return text;
+		}
+
+	} // namespace
+
+	Value::Value(const Value& other) {
+		if (other.on_heap()) {
+			set_string(other.chars());
+			cell_[flags_byte] = other.cell_[flags_byte];
+		}
+		else {
+			std::memcpy(cell_, other.cell_, sizeof(cell_));
+		}
 	}
 
-	int64_t Value::as_int() const {
-		if (std::holds_alternative<int64_t>(data_)) {
-			return std::get<int64_t>(data_);
+	Value::Value(Value&& other) noexcept {
+		std::memcpy(cell_, other.cell_, sizeof(cell_));
+		other.set_inline({});
+	}
+
+	Value& Value::operator=(const Value& other) {
+		if (this != &other) {
+			Value copy(other);
+			*this = std::move(copy);
 		}
-		if (std::holds_alternative<double>(data_)) {
-			return static_cast<int64_t>(std::get<double>(data_));
+		return *this;
+	}
+
+	Value& Value::operator=(Value&& other) noexcept {
+		if (this != &other) {
+			release();
+			std::memcpy(cell_, other.cell_, sizeof(cell_));
+			other.set_inline({});
+		}
+		return *this;
+	}
+
+	void Value::set_inline(std::string_view val) noexcept {
+		std::memset(cell_, 0, sizeof(cell_));
+		if (!val.empty()) std::memcpy(cell_, val.data(), val.size());
+		cell_[length_byte] = static_cast<unsigned char>(val.size());
+		cell_[flags_byte] = static_cast<unsigned char>(Kind::String);
+	}
+
+	void Value::set_string(std::string_view val) {
+		if (val.size() <= inline_capacity) {
+			set_inline(val);
+			return;
+		}
+		if (val.size() > std::numeric_limits<uint32_t>::max()) {
+			throw std::length_error("Value string too long");
+		}
+
+		// Exact-size block, no capacity slack or terminator
+		char* block = new char[val.size()];
+		std::memcpy(block, val.data(), val.size());
+		uint32_t size = static_cast<uint32_t>(val.size());
+
+		std::memset(cell_, 0, sizeof(cell_));
+		std::memcpy(cell_, &block, sizeof(block));
+		std::memcpy(cell_ + 8, &size, sizeof(size));
+		cell_[flags_byte] = static_cast<unsigned char>(Kind::String) | heap_flag;
+	}
+
+	void Value::release() const noexcept {
+		if (on_heap()) delete[] word<char*>();
+	}
+
+	std::string_view Value::chars() const noexcept {
+		if (on_heap()) {
+			uint32_t size;
+			std::memcpy(&size, cell_ + 8, sizeof(size));
+			return { word<char*>(), size };
 		}
-		if (std::holds_alternative<std::string>(data_)) {
-			const auto& s = std::get<std::string>(data_);
+		return { reinterpret_cast<const char*>(cell_), cell_[length_byte] };
+	}
+
+	void Value::resolve_pending() const {
+		Value typed = Parser::parse_value(chars());
+		release();
+		std::memcpy(cell_, typed.cell_, sizeof(cell_));
+		typed.set_inline({});
+	}
+
+	std::string_view Value::as_string_view() const {
+		resolve();
+		return kind() == Kind::String ? chars() : std::string_view();
+	}
+
+	Value::Variant Value::to_variant() const {
+		resolve();
+		switch (kind()) {
+		case Kind::Int: return word<int64_t>();
+		case Kind::Double: return word<double>();
+		case Kind::Bool: return word<bool>();
+		default: return std::string(chars());
+		}
+	}
+
+	bool Value::operator==(const Value& other) const {
+		resolve();
+		other.resolve();
+		if (kind() != other.kind()) return false;
+		switch (kind()) {
+		case Kind::Int: return word<int64_t>() == other.word<int64_t>();
+		case Kind::Double: return word<double>() == other.word<double>();
+		case Kind::Bool: return word<bool>() == other.word<bool>();
+		default: return chars() == other.chars();
+		}
+	}
+
+	bool Value::same_text(const Value& other) const {
+		if (*this == other) return true;
+		if (kind() == other.kind()) return false;
+		char buf[number_chars];
+		char other_buf[number_chars];
+		return text(buf) == other.text(other_buf);
+	}
+
+	std::string_view Value::text(char* buf) const {
+		resolve();
+		switch (kind()) {
+		case Kind::Int: return format_int(word<int64_t>(), buf);
+		case Kind::Double: return format_double(word<double>(), buf);
+		case Kind::Bool: return word<bool>() ? "1" : "0";
+		default: return chars();
+		}
+	}
+
+	std::string Value::as_string() const {
+		char buf[number_chars];
+		return std::string(text(buf));
+	}
+
+	int64_t Value::as_int() const {
+		resolve();
+		switch (kind()) {
+		case Kind::Int: return word<int64_t>();
+		case Kind::Double: return static_cast<int64_t>(word<double>());
+		case Kind::Bool: return word<bool>() ? 1 : 0;
+		default: {
+			std::string_view s = chars();
 			int64_t result = 0;
 			std::from_chars(s.data(), s.data() + s.size(), result);
 			return result;
 		}
-		return std::get<bool>(data_) ? 1 : 0;
+		}
 	}
 
 	double Value::as_double() const {
-		if (std::holds_alternative<double>(data_)) {
-			return std::get<double>(data_);
+		resolve();
+		switch (kind()) {
+		case Kind::Int: return static_cast<double>(word<int64_t>());
+		case Kind::Double: return word<double>();
+		case Kind::Bool: return word<bool>() ? 1.0 : 0.0;
+		default: {
+			// Like as_int: 0 when the text is not a representable number
+			double result = 0;
+			return Parser::parse_double(chars(), result) ? result : 0.0;
 		}
-		if (std::holds_alternative<int64_t>(data_)) {
-			return static_cast<double>(std::get<int64_t>(data_));
 		}
-		if (std::holds_alternative<std::string>(data_)) {
-			return std::stod(std::get<std::string>(data_));
-		}
-		return std::get<bool>(data_) ? 1.0 : 0.0;
 	}
 
 	bool Value::as_bool() const {
-		if (std::holds_alternative<bool>(data_)) {
-			return std::get<bool>(data_);
+		resolve();
+		switch (kind()) {
+		case Kind::Int: return word<int64_t>() != 0;
+		case Kind::Double: return word<double>() != 0.0;
+		case Kind::Bool: return word<bool>();
+		default: {
+			std::string_view s = chars();
+			return !s.empty() && s != "0" && s != "false" && s != "False";
 		}
-		if (std::holds_alternative<int64_t>(data_)) {
-			return std::get<int64_t>(data_) != 0;
 		}
-		if (std::holds_alternative<double>(data_)) {
-			return std::get<double>(data_) != 0.0;
+	}
+
+	void Value::append_to(std::string& out) const {
+		char buf[number_chars];
+		std::string_view text = this->text(buf);
+
+		// Escape quotes and backslashes, copying the runs between them in bulk
+		out += '"';
+		size_t start = 0;
+		for (size_t i = 0; i < text.size(); ++i) {
+			if (text[i] != '\\' && text[i] != '"') continue;
+			out.append(text.data() + start, i - start);
+			out += '\\';
+			start = i;
 		}
-		const auto& s = std::get<std::string>(data_);
-		return !s.empty() && s != "0" && s != "false" && s != "False";
+		out.append(text.data() + start, text.size() - start);
+		out += '"';
 	}
 
 	std::string Value::to_string() const {
-		return std::visit([](auto&& arg) -> std::string {
-			using T = std::decay_t<decltype(arg)>;
-			if constexpr (std::is_same_v<T, std::string>) {
-				// Escape quotes and backslashes
-				std::string result = "\"";
-				for (char c : arg) {
-					if (c == '\\' || c == '"') result += '\\';
-					result += c;
-				}
-				result += '"';
-				return result;
-			}
-			else if constexpr (std::is_same_v<T, bool>) {
-				return arg ? "\"1\"" : "\"0\"";
-			}
-			else {
-				return "\"" + std::to_string(arg) + "\"";
-			}
-			}, data_);
+		std::string result;
+		append_to(result);
+		return result;
 	}
 
 } // namespace bstk
\ No newline at end of file
@@ -0,0 +1,1033 @@
+#include <bstk/bstk.hpp>
+#include <bstk/tokenizer.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <random>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+// Every allocation in the process goes through here, so tests can assert
+// that a code path allocates nothing
+static std::atomic<size_t> allocations{ 0 };
+
+void* operator new(std::size_t size) {
+	++allocations;
+	if (void* p = std::malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+namespace {
+
+	int failures = 0;
+
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #cond "\n"; \
+			++failures; \
+		} \
+	} while (0)
+
+	// ============================================
+	// Key handles
+	// ============================================
+
+	void lookups_do_not_allocate() {
+		// Keys well past any small-string buffer
+		constexpr const char* key = "bst.instance.Pie64_12.display_name_that_is_long";
+		constexpr const char* missing = "bst.instance.Pie64_12.a_key_that_was_never_set";
+		bstk::Config config;
+		config.set_int(key, 7);
+		const bstk::Config& view = config;
+
+		size_t before = allocations.load();
+		bool ok = view.has(key) && view.has(std::string_view(key)) && !view.has(missing);
+		ok = ok && view.get(key) && view.get(std::string_view(key)) && !view.get(missing);
+		ok = ok && view.get_or<int>(key, 0) == 7 && view.get_or<int64_t>(std::string_view(key), 0) == 7;
+		ok = ok && view.get_or<int>(missing, 3) == 3;
+		size_t allocated = allocations.load() - before;
+		CHECK(ok);
+		CHECK(allocated == 0);
+
+		// The counter itself works
+		before = allocations.load();
+		std::string(key).swap(*std::make_unique<std::string>());
+		CHECK(allocations.load() > before);
+	}
+
+	void resolve_grows_free_list_geometrically() {
+		bstk::Config config;
+		std::vector<std::string> keys;
+		for (int i = 0; i < 4096; ++i) keys.push_back("bst.k" + std::to_string(i));
+		for (const auto& key : keys) config.set_int(key, 1);
+
+		// Per new handle: one hash node for the slot lookup, plus an
+		// occasional geometric regrowth of the slot and free-slot tables
+		size_t before = allocations.load();
+		for (const auto& key : keys) CHECK(config.resolve(key).valid());
+		size_t allocated = allocations.load() - before;
+		CHECK(allocated < keys.size() + 200);
+	}
+
+	void handle_stale_after_copy_assign() {
+		bstk::Config a;
+		a.set_int("bst.a", 1);
+		bstk::KeyHandle handle = a.resolve("bst.a");
+		CHECK(a.get(handle) != nullptr);
+
+		bstk::Config b;
+		b.set_int("bst.a", 42);
+		a = b;
+		CHECK(a.get(handle) == nullptr);
+		CHECK(!a.set(handle, bstk::Value(int64_t{ 7 })));
+		CHECK(a.get_or<int>("bst.a", 0) == 42);
+
+		// Fresh handles never alias the stale one
+		bstk::KeyHandle fresh = a.resolve("bst.a");
+		CHECK(!(fresh == handle));
+		CHECK(a.get(handle) == nullptr);
+	}
+
+	void handle_stale_after_move_assign() {
+		bstk::Config a;
+		a.set_int("bst.a", 1);
+		bstk::KeyHandle handle = a.resolve("bst.a");
+
+		bstk::Config b;
+		b.set_int("bst.a", 42);
+		bstk::KeyHandle moved = b.resolve("bst.a");
+		a = std::move(b);
+		CHECK(a.get(handle) == nullptr);
+		CHECK(a.get(moved) == nullptr);
+		CHECK(a.get_or<int>("bst.a", 0) == 42);
+	}
+
+	void handle_stale_after_clear() {
+		bstk::Config config;
+		for (int i = 0; i < 100; ++i) config.set_int("bst.k" + std::to_string(i), i);
+		std::vector<bstk::KeyHandle> handles;
+		for (int i = 0; i < 100; ++i) handles.push_back(config.resolve("bst.k" + std::to_string(i)));
+		config.clear();
+		for (const auto& handle : handles) CHECK(config.get(handle) == nullptr);
+	}
+
+	// ============================================
+	// Subscriptions
+	// ============================================
+
+	void subscriptions_survive_assignment() {
+		bstk::Config config;
+		int notified = 0;
+		config.subscribe("bst.", [&](const std::vector<std::string>&) { ++notified; });
+
+		bstk::Config source;
+		source.set_int("bst.a", 1);
+		config = source;
+		config.set_int("bst.a", 2);
+		CHECK(notified == 1);
+
+		config = bstk::Config(source);
+		config.set_int("bst.a", 3);
+		CHECK(notified == 2);
+
+		// The source's subscribers do not move over either
+		bstk::Config other;
+		int other_notified = 0;
+		other.subscribe("", [&](const std::vector<std::string>&) { ++other_notified; });
+		config = std::move(other);
+		config.set_int("bst.b", 1);
+		CHECK(notified == 3);
+		CHECK(other_notified == 0);
+	}
+
+	void throwing_callback_in_batch_is_contained() {
+		bstk::Config config;
+		int notified = 0;
+		config.subscribe("bst.a", [](const std::vector<std::string>&) { throw std::runtime_error("callback"); });
+		config.subscribe("bst.", [&](const std::vector<std::string>&) { ++notified; });
+
+		try {
+			bstk::Config::NotificationBatch batch(config);
+			config.set_int("bst.a", 1);
+			throw std::runtime_error("unwind");
+		}
+		catch (const std::runtime_error& e) {
+			CHECK(std::string(e.what()) == "unwind");
+		}
+		CHECK(notified == 1);
+
+		{
+			bstk::Config::NotificationBatch batch(config);
+			config.set_int("bst.a", 2);
+		}
+		CHECK(notified == 2);
+	}
+
+	void batch_survives_assignment() {
+		bstk::Config config;
+		bstk::Config other;
+		other.set_int("bst.b", 2);
+		int notified = 0;
+		config.subscribe("bst.", [&](const std::vector<std::string>&) { ++notified; });
+
+		config.begin_batch();
+		config.set_int("bst.a", 1);
+		config = other;
+		CHECK(config.in_batch());
+		config = bstk::Config(other);
+		CHECK(config.in_batch());
+		CHECK(notified == 0);
+		// Nothing left to undo, the assigned content stays
+		CHECK(config.rollback());
+		CHECK(!config.in_batch());
+		CHECK(notified == 1);
+		CHECK(config.get_or<int>("bst.b", 0) == 2);
+
+		config.set_int("bst.c", 3);
+		CHECK(notified == 2);
+		CHECK(!config.commit());
+	}
+
+	void rollback_across_reload() {
+		bstk::Config config;
+		CHECK(config.load_from_string("a=\"1\"\nb=\"2\"\n"));
+
+		config.begin_batch();
+		config.set_int("a", 5);
+		CHECK(config.remove("b"));
+		std::vector<std::string> changed;
+		CHECK(config.reload_from_string("a=\"7\"\nc=\"3\"\n", changed));
+		CHECK(config.in_batch());
+		config.set_int("d", 4);
+		CHECK(config.rollback());
+
+		// Only the change after the reload is undone
+		CHECK(config.size() == 2);
+		CHECK(config.get_or<int>("a", 0) == 7);
+		CHECK(config.get("b") == nullptr);
+		CHECK(config.get_or<int>("c", 0) == 3);
+		CHECK(config.get("d") == nullptr);
+	}
+
+	void batch_guard_rolls_back_on_unwind() {
+		bstk::Config config;
+		config.set_int("bst.a", 1);
+		int notified = 0;
+		config.subscribe("bst.", [&](const std::vector<std::string>&) { ++notified; });
+
+		try {
+			bstk::Config::Batch batch(config);
+			config.set_int("bst.a", 2);
+			config.set_int("bst.b", 3);
+			throw std::runtime_error("save failed");
+		}
+		catch (const std::runtime_error&) {
+		}
+		CHECK(!config.in_batch());
+		CHECK(config.get_or<int>("bst.a", 0) == 1);
+		CHECK(config.get("bst.b") == nullptr);
+		// Rolled-back changes are never announced
+		CHECK(notified == 0);
+
+		{
+			bstk::Config::Batch batch(config);
+			config.set_int("bst.a", 4);
+			CHECK(batch.commit());
+			CHECK(!batch.commit());
+		}
+		CHECK(!config.in_batch());
+		CHECK(config.get_or<int>("bst.a", 0) == 4);
+		CHECK(notified == 1);
+	}
+
+	void shared_config_reader_follows_version() {
+		bstk::SharedConfig shared;
+		bstk::SharedConfig::Reader reader(shared);
+		CHECK(reader.current().empty());
+
+		shared.set("bst.a", bstk::Value(int64_t{ 1 }));
+		CHECK(shared.version() == 1);
+		CHECK(reader.current().get_or<int>("bst.a", 0) == 1);
+
+		const bstk::ConfigSnapshot* first = &reader.current();
+		CHECK(&reader.current() == first);
+		shared.set("bst.a", bstk::Value(int64_t{ 1 }));
+		CHECK(&reader.current() == first);
+
+		bstk::Config config;
+		config.set_int("bst.b", 2);
+		shared.assign(config);
+		CHECK(shared.version() == 2);
+		CHECK(!reader.current().has("bst.a"));
+		CHECK(reader.current().get_or<int>("bst.b", 0) == 2);
+	}
+
+	void concurrent_prefix_queries() {
+		bstk::Config config;
+		CHECK(config.load_from_string("bst.b=\"2\"\nbst.a=\"1\"\nother=\"3\"\nbst.c=\"4\"\n"));
+
+		// The first query on each thread races to rebuild the sorted index
+		std::atomic<int> mismatches{ 0 };
+		std::vector<std::thread> readers;
+		for (int i = 0; i < 4; ++i) {
+			readers.emplace_back([&] {
+				for (int n = 0; n < 100; ++n) {
+					auto keys = config.get_keys_with_prefix("bst.");
+					if (keys != std::vector<std::string>{ "bst.a", "bst.b", "bst.c" }) ++mismatches;
+				}
+			});
+		}
+		for (auto& reader : readers) reader.join();
+		CHECK(mismatches == 0);
+	}
+
+	// Spans of every line as Parser::split_line sees them
+	std::vector<std::pair<std::string_view, std::string_view>> reference_spans(std::string_view content) {
+		std::vector<std::pair<std::string_view, std::string_view>> spans;
+		while (!content.empty()) {
+			size_t end = content.find('\n');
+			std::string_view line = content.substr(0, end);
+			if (auto span = bstk::Parser::split_line(line)) spans.emplace_back(span->key, span->value);
+			content.remove_prefix(end == std::string_view::npos ? content.size() : end + 1);
+		}
+		return spans;
+	}
+
+	bool kernel_matches(std::string_view content, bstk::Tokenizer::Kernel kernel) {
+		std::vector<std::pair<std::string_view, std::string_view>> spans;
+		bstk::Tokenizer tokenizer(content, kernel);
+		bstk::LineSpan span;
+		while (tokenizer.next(span)) spans.emplace_back(span.key, span.value);
+		// Same views into content, not just equal text (empty views may point anywhere)
+		auto same_view = [](std::string_view a, std::string_view b) {
+			return a.size() == b.size() && (a.empty() || a.data() == b.data());
+		};
+		auto same = [&](const auto& a, const auto& b) {
+			return same_view(a.first, b.first) && same_view(a.second, b.second);
+		};
+		auto expected = reference_spans(content);
+		return std::equal(spans.begin(), spans.end(), expected.begin(), expected.end(), same);
+	}
+
+	void tokenizer_kernels_match_split_line() {
+		using Kernel = bstk::Tokenizer::Kernel;
+		std::vector<Kernel> kernels;
+		for (Kernel kernel : { Kernel::Auto, Kernel::Scalar, Kernel::Sse2, Kernel::Avx2 }) {
+			if (bstk::Tokenizer::supported(kernel)) kernels.push_back(kernel);
+		}
+		CHECK(bstk::Tokenizer::supported(Kernel::Scalar));
+
+		std::vector<std::string> inputs = {
+			"", "\n", "\r\n", "=", "a=", "=b", "a=b", "a=b\n", "a=b\r\n", "a=b=c\n", "  a  =  b  \n",
+			"# c=d\na=1\n\n\n  # x\nb=2", "no equals\nk=v", "\r\n\r\nk=\"v=w\"\r\n#=\r\n",
+		};
+
+		// Keys and values straddling the 16-, 32- and 64-byte block edges
+		for (size_t key = 1; key <= 70; ++key) {
+			for (size_t value : { 0, 1, 14, 15, 16, 17, 31, 32, 33, 63, 64, 65 }) {
+				std::string line = std::string(key, 'k') + "=" + std::string(value, 'v');
+				inputs.push_back(line);
+				inputs.push_back(line + "\r\n" + line);
+				inputs.push_back(std::string(key % 17, '\n') + "# " + line + "\n" + line + "=x\n");
+			}
+		}
+
+		// Random documents over the characters the tokenizer cares about
+		std::mt19937 rng(12345);
+		const char alphabet[] = { 'a', 'b', '=', '=', ' ', '\t', '\n', '\n', '\r', '#', '"' };
+		for (int i = 0; i < 3000; ++i) {
+			std::string doc(rng() % 300, ' ');
+			for (char& c : doc) c = alphabet[rng() % sizeof(alphabet)];
+			inputs.push_back(std::move(doc));
+		}
+
+		int mismatches = 0;
+		for (const auto& input : inputs) {
+			for (Kernel kernel : kernels) {
+				if (!kernel_matches(input, kernel)) ++mismatches;
+			}
+		}
+		CHECK(mismatches == 0);
+	}
+
+	void extreme_doubles_round_trip() {
+		const double values[] = {
+			1e-310, std::numeric_limits<double>::denorm_min(), std::numeric_limits<double>::min(),
+			std::numeric_limits<double>::max(), -std::numeric_limits<double>::max(), -0.0, 0.1,
+		};
+		bstk::Config config;
+		for (size_t i = 0; i < std::size(values); ++i) {
+			config.set_double("bst.d" + std::to_string(i), values[i]);
+		}
+
+		bstk::Config loaded;
+		CHECK(loaded.load_from_string(config.to_string()));
+		for (size_t i = 0; i < std::size(values); ++i) {
+			const bstk::Value* value = loaded.get("bst.d" + std::to_string(i));
+			CHECK(value && value->is_double());
+			CHECK(value && value->as_double() == values[i] && std::signbit(value->as_double()) == std::signbit(values[i]));
+		}
+
+		// Digits beyond the double range stay text instead of throwing
+		std::string huge = "1" + std::string(400, '0') + ".5";
+		CHECK(loaded.load_from_string("bst.huge=\"" + huge + "\"\nbst.tiny=\"0." + std::string(400, '0') + "1\"\n"));
+		CHECK(loaded.get("bst.huge")->is_string());
+		CHECK(loaded.get("bst.huge")->as_string() == huge);
+		CHECK(loaded.get("bst.tiny")->is_string());
+		CHECK(loaded.get("bst.huge")->as_double() == 0.0);
+		CHECK(bstk::Value(std::string_view("not a number")).as_double() == 0.0);
+		CHECK(bstk::Value(std::string_view("+2.5")).as_double() == 2.5);
+	}
+
+	void lazy_values_match_eager() {
+		// Every kind inference distinguishes, plus escapes, empties and edge numbers
+		const std::string content =
+			"bst.int=\"42\"\n"
+			"bst.neg=\"-17\"\n"
+			"bst.big=\"9223372036854775807\"\n"
+			"bst.huge=\"99999999999999999999\"\n"
+			"bst.one=\"1\"\n"
+			"bst.zero=\"0\"\n"
+			"bst.true=\"true\"\n"
+			"bst.False=\"False\"\n"
+			"bst.dbl=\"2.5\"\n"
+			"bst.exp=\"-1e-3\"\n"
+			"bst.tiny=\"1e-400\"\n"
+			"bst.empty=\"\"\n"
+			"bst.short=\"abc\"\n"
+			"bst.long=\"a string longer than the inline capacity\"\n"
+			"bst.escaped=\"say \\\"hi\\\"\\n\\tC:\\\\path\"\n"
+			"bst.bare=12\n"
+			"bst.spaced =  \"  padded  \"  \n";
+
+		bstk::Config eager;
+		bstk::Config lazy;
+		lazy.set_lazy_values(true);
+		CHECK(eager.load_from_string(content));
+		CHECK(lazy.load_from_string(content));
+		CHECK(lazy.size() == eager.size());
+
+		for (const auto& key : eager.get_keys_with_prefix("bst.")) {
+			const bstk::Value* e = eager.get(key);
+			const bstk::Value* l = lazy.get(key);
+			CHECK(e && l);
+			if (!e || !l) continue;
+			CHECK(!e->is_pending());
+			CHECK(l->is_pending());
+
+			// Copies of a pending value resolve independently to the same result
+			bstk::Value copy = *l;
+			CHECK(copy.to_variant() == e->to_variant());
+
+			CHECK(l->is_string() == e->is_string());
+			CHECK(l->is_int() == e->is_int());
+			CHECK(l->is_double() == e->is_double());
+			CHECK(l->is_bool() == e->is_bool());
+			CHECK(!l->is_pending());
+			CHECK(*l == *e);
+			CHECK(l->as_string() == e->as_string());
+			CHECK(l->as_string_view() == e->as_string_view());
+			CHECK(l->as_int() == e->as_int());
+			CHECK(l->as_bool() == e->as_bool());
+			double ld = l->as_double(), ed = e->as_double();
+			CHECK(ld == ed || (std::isnan(ld) && std::isnan(ed)));
+			CHECK(l->to_string() == e->to_string());
+			CHECK(l->same_text(*e));
+		}
+		CHECK(lazy.to_string(bstk::SerializeOrder::Insertion) == eager.to_string(bstk::SerializeOrder::Insertion));
+
+		// Typed getters on a fresh lazy load, before anything was resolved
+		bstk::Config fresh;
+		fresh.set_lazy_values(true);
+		CHECK(fresh.load_from_string(content));
+		CHECK(fresh.get_or<int>("bst.int", 0) == 42);
+		CHECK(fresh.get_or<double>("bst.dbl", 0.0) == 2.5);
+		CHECK(fresh.get_or<bool>("bst.true", false));
+		CHECK(fresh.get_or<std::string>("bst.escaped", "") == "say \"hi\"\n\tC:\\path");
+		CHECK(fresh.to_string(bstk::SerializeOrder::Sorted) == eager.to_string(bstk::SerializeOrder::Sorted));
+	}
+
+	void stream_parser_ignores_chunk_boundaries() {
+		// CRLF and LF endings, a comment, a blank line, escapes, a repeated key
+		// and a final line without a newline
+		const std::string content =
+			"bst.feature.rooting=\"1\"\r\n"
+			"# comment = \"no\"\r\n"
+			"\r\n"
+			"bst.instance.Pie64.display_name=\"Pie \\\"64\\\"\"\n"
+			"bst.instance.Pie64.ram=\"4096\"\r\n"
+			"bst.feature.rooting=\"0\"\n"
+			"bst.last=\"2.5\"";
+
+		bstk::Config reference;
+		CHECK(reference.load_from_string(content));
+		const std::string expected = reference.to_string(bstk::SerializeOrder::Insertion);
+		CHECK(reference.size() == 4);
+
+		// Callback mode reports every line, the repeated key included
+		using Entries = std::vector<std::pair<std::string, bstk::Value>>;
+		auto collect = [](Entries& into) {
+			return bstk::ConfigStreamParser([&into](std::string_view key, bstk::Value&& value) {
+				into.emplace_back(std::string(key), std::move(value));
+			});
+		};
+		Entries expected_entries;
+		auto whole = collect(expected_entries);
+		whole.feed(content);
+		whole.finish();
+		CHECK(expected_entries.size() == 5);
+
+		auto check_chunks = [&](const std::vector<std::string_view>& chunks) {
+			bstk::Config config;
+			bstk::ConfigStreamParser into_config(config);
+			Entries seen;
+			auto with_callback = collect(seen);
+			for (auto chunk : chunks) {
+				into_config.feed(chunk);
+				with_callback.feed(chunk);
+			}
+			into_config.finish();
+			with_callback.finish();
+			CHECK(into_config.buffered() == 0);
+			CHECK(into_config.entries() == 5);
+			CHECK(config.to_string(bstk::SerializeOrder::Insertion) == expected);
+			CHECK(seen == expected_entries);
+		};
+
+		// Every single split point, which includes inside "\r\n", inside keys
+		// and right after the '='
+		std::string_view all(content);
+		for (size_t i = 0; i <= all.size(); ++i) {
+			check_chunks({ all.substr(0, i), all.substr(i) });
+		}
+
+		// Every pair of split points, so a line can span three chunks
+		for (size_t i = 0; i <= all.size(); ++i) {
+			for (size_t j = i; j <= all.size(); j += 3) {
+				check_chunks({ all.substr(0, i), all.substr(i, j - i), all.substr(j) });
+			}
+		}
+
+		// One byte at a time
+		std::vector<std::string_view> bytes;
+		for (size_t i = 0; i < all.size(); ++i) bytes.push_back(all.substr(i, 1));
+		check_chunks(bytes);
+
+		// Stream input with small fixed chunks
+		for (size_t chunk_size : { 1, 2, 3, 7, 64 }) {
+			std::istringstream in(content);
+			bstk::Config config;
+			bstk::ConfigStreamParser parser(config);
+			CHECK(parser.feed(in, chunk_size));
+			parser.finish();
+			CHECK(config.to_string(bstk::SerializeOrder::Insertion) == expected);
+		}
+	}
+
+	void instance_round_trips_every_field() {
+		// Keys around and between the table's fields, and a neighbouring
+		// instance whose name extends this one
+		bstk::Config config;
+		CHECK(config.load_from_string(
+			"bst.instance.Pie64.aaa_unknown=\"x\"\n"
+			"bst.instance.Pie64.android_id=\"a1b2c3\"\n"
+			"bst.instance.Pie64.cpus=\"8\"\n"
+			"bst.instance.Pie64.display_name=\"Main \\\"Pie\\\"\"\n"
+			"bst.instance.Pie64.enable_root_access=\"1\"\n"
+			"bst.instance.Pie64.enable_notifications=\"0\"\n"
+			"bst.instance.Pie64.google_account_logins=\"me@example.com\"\n"
+			"bst.instance.Pie64.ram=\"8192\"\n"
+			"bst.instance.Pie64.zzz_unknown=\"y\"\n"
+			"bst.instance.Pie64_1.cpus=\"2\"\n"
+			"bst.instance.Pie64_1.android_id=\"other\"\n"));
+
+		bstk::Instance pie(config, "Pie64");
+		const auto& props = pie.props();
+		CHECK(props.android_id == "a1b2c3");
+		CHECK(props.google_account_logins == "me@example.com");
+		CHECK(props.cpus == 8);
+		CHECK(props.ram == 8192);
+		CHECK(props.display_name == "Main \"Pie\"");
+		CHECK(props.enable_root_access);
+		CHECK(!props.enable_notifications);
+		// Absent keys keep their defaults
+		CHECK(props.fb_width == 1280);
+		CHECK(props.graphics_engine == "aga");
+
+		bstk::Instance other(config, "Pie64_1");
+		CHECK(other.props().cpus == 2);
+		CHECK(other.props().android_id == "other");
+		CHECK(other.props().ram == 4096);
+
+		// Every field written by save_to_config reads back the same, each
+		// under its own key
+		pie.props().android_google_ad_id = "ad-id";
+		pie.props().abi_list = "x86,x86_64";
+		pie.resolution(1920, 1080).dpi(320).adb_port(5565).vulkan(true).sidebar(false);
+		pie.save_to_config();
+		CHECK(config.get_or<std::string>("bst.instance.Pie64.android_id", "") == "a1b2c3");
+		CHECK(config.get_or<std::string>("bst.instance.Pie64.google_account_logins", "") == "me@example.com");
+		CHECK(config.get_or<std::string>("bst.instance.Pie64.android_google_ad_id", "") == "ad-id");
+		CHECK(config.get_or<std::string>("bst.instance.Pie64.aaa_unknown", "") == "x");
+		CHECK(config.get_or<int>("bst.instance.Pie64_1.cpus", 0) == 2);
+
+		// Loading the saved text and saving into an empty Config writes every
+		// field, and only the fields, with the same values
+		bstk::Config copy;
+		CHECK(copy.load_from_string(config.to_string(bstk::SerializeOrder::Insertion)));
+		bstk::Instance reloaded(copy, "Pie64");
+		bstk::Config resaved;
+		bstk::Instance target(resaved, "Pie64");
+		target.props() = reloaded.props();
+		target.save_to_config();
+		CHECK(resaved.size() == 32);
+		for (const auto& key : resaved.get_keys_with_prefix("")) {
+			const bstk::Value* saved = config.get(key);
+			CHECK(saved && *saved == *resaved.get(key));
+		}
+	}
+
+	// Every column, bitset and filter of the table against the manager's rows
+	void check_table_matches(const bstk::InstanceTable& table, const bstk::InstanceManager& mgr) {
+		using Table = bstk::InstanceTable;
+		using Properties = bstk::Instance::Properties;
+		constexpr int Properties::* columns[] = {
+			&Properties::fb_width, &Properties::fb_height, &Properties::dpi, &Properties::max_fps,
+			&Properties::cpus, &Properties::ram, &Properties::adb_port,
+		};
+		constexpr bool Properties::* flags[] = {
+			&Properties::enable_high_fps, &Properties::enable_vsync, &Properties::enable_fullscreen_all_apps,
+			&Properties::enable_fps_display, &Properties::enable_root_access, &Properties::enable_notifications,
+			&Properties::game_controls_enabled, &Properties::show_sidebar, &Properties::pin_to_top,
+			&Properties::airplane_mode_active, &Properties::vulkan_supported, &Properties::android_sound_while_tapping,
+		};
+
+		CHECK(table.size() == mgr.count());
+		if (table.size() != mgr.count()) return;
+
+		auto rows_where = [&](auto pred) {
+			Table::IndexList rows;
+			for (Table::Index row = 0; row < mgr.count(); ++row) {
+				if (pred(mgr[row].props())) rows.push_back(row);
+			}
+			return rows;
+		};
+
+		for (Table::Index row = 0; row < mgr.count(); ++row) {
+			CHECK(table.name(row) == mgr[row].name());
+		}
+		for (size_t c = 0; c < std::size(columns); ++c) {
+			auto column = table.column(static_cast<Table::Column>(c));
+			CHECK(column.size() == mgr.count());
+			int64_t sum = 0;
+			for (Table::Index row = 0; row < mgr.count(); ++row) {
+				CHECK(column[row] == mgr[row].props().*columns[c]);
+				sum += mgr[row].props().*columns[c];
+			}
+			CHECK(table.sum(static_cast<Table::Column>(c)) == sum);
+		}
+		for (size_t f = 0; f < std::size(flags); ++f) {
+			auto flag = static_cast<Table::Flag>(f);
+			for (Table::Index row = 0; row < mgr.count(); ++row) {
+				CHECK(table.flag(flag, row) == mgr[row].props().*flags[f]);
+			}
+			auto expected = rows_where([&](const Properties& p) { return p.*flags[f]; });
+			CHECK(table.with_flag(flag) == expected);
+			CHECK(table.count(flag) == expected.size());
+		}
+
+		auto big = rows_where([](const Properties& p) { return p.ram >= 3072; });
+		auto mid = rows_where([](const Properties& p) { return p.ram >= 2048 && p.ram <= 3072; });
+		auto quad = rows_where([](const Properties& p) { return p.cpus == 4; });
+		auto hd = rows_where([](const Properties& p) { return p.fb_width == 1920 && p.fb_height == 1080; });
+		CHECK(table.where_at_least(Table::Column::Ram, 3072) == big);
+		CHECK(table.where_between(Table::Column::Ram, 2048, 3072) == mid);
+		CHECK(table.where_equal(Table::Column::Cpus, 4) == quad);
+		CHECK(table.matching_resolution(1920, 1080) == hd);
+		CHECK(table.with_root_access() == rows_where([](const Properties& p) { return p.enable_root_access; }));
+		CHECK(Table::intersect(big, quad) == rows_where([](const Properties& p) { return p.ram >= 3072 && p.cpus == 4; }));
+
+		int64_t big_ram = 0;
+		for (auto row : big) big_ram += mgr[row].props().ram;
+		CHECK(table.sum(Table::Column::Ram, big) == big_ram);
+	}
+
+	void instance_table_tracks_add_and_remove() {
+		bstk::Config config;
+		bstk::InstanceManager mgr(config);
+		int next = 0;
+		auto add = [&] {
+			int i = next++;
+			auto& inst = mgr.create("Pie64_" + std::to_string(i));
+			inst.performance(1 + i % 8, 1024 * (1 + i % 4)).root_access(i % 3 == 0).fps(60, i % 5 == 0);
+			if (i % 2) inst.resolution(1920, 1080);
+			inst.props().pin_to_top = i % 7 == 0;
+			inst.props().vulkan_supported = i % 64 == 63;
+		};
+
+		// Enough rows for partial and full bitset words
+		for (int i = 0; i < 150; ++i) add();
+		bstk::InstanceTable table(mgr);
+		check_table_matches(table, mgr);
+
+		// Removing rows on and around word boundaries shifts later rows down
+		for (const char* name : { "Pie64_0", "Pie64_63", "Pie64_64", "Pie64_128", "Pie64_149" }) {
+			CHECK(mgr.remove(name));
+		}
+		table.clear();
+		CHECK(table.empty());
+		CHECK(table.with_root_access().empty());
+		table.append(mgr);
+		CHECK(table.size() == 145);
+		check_table_matches(table, mgr);
+
+		// New instances reuse freed slots but append in creation order
+		for (int i = 0; i < 20; ++i) add();
+		table.clear();
+		for (const auto& inst : mgr) table.append(inst);
+		check_table_matches(table, mgr);
+		check_table_matches(bstk::InstanceTable(mgr), mgr);
+
+		// Removing everything leaves an empty table with empty results
+		while (!mgr.empty()) CHECK(mgr.remove(mgr[0].name()));
+		table = bstk::InstanceTable(mgr);
+		check_table_matches(table, mgr);
+		CHECK(table.where_at_least(bstk::InstanceTable::Column::Ram, 0).empty());
+	}
+
+	void instance_views_filter_lazily() {
+		static_assert(std::ranges::random_access_range<decltype(std::declval<bstk::InstanceManager&>().view())>);
+		static_assert(std::ranges::random_access_range<decltype(std::declval<const bstk::InstanceManager&>().view())>);
+
+		bstk::Config config;
+		bstk::InstanceManager mgr(config);
+		for (int i = 0; i < 12; ++i) {
+			auto& inst = mgr.create("Pie64_" + std::to_string(i));
+			inst.performance(1 + i % 4, 1024 * (1 + i % 6)).root_access(i % 3 == 0).fps(60, i % 2 == 0);
+			if (i % 4 == 1) inst.resolution(1920, 1080);
+		}
+
+		auto names = [](auto&& range) {
+			std::vector<std::string> result;
+			for (const bstk::Instance& inst : range) result.push_back(inst.name());
+			return result;
+		};
+		auto names_of = [](const auto& list) {
+			std::vector<std::string> result;
+			for (const auto& inst : list) {
+				if constexpr (std::is_pointer_v<std::decay_t<decltype(inst)>>) result.push_back(inst->name());
+				else result.push_back(inst.get().name());
+			}
+			return result;
+		};
+		auto expected = [&](auto pred) {
+			std::vector<std::string> result;
+			for (const auto& inst : mgr) {
+				if (pred(inst.props())) result.push_back(inst.name());
+			}
+			return result;
+		};
+		using Properties = bstk::Instance::Properties;
+
+		// Each adaptor alone agrees with the eager helpers and a plain loop
+		CHECK(names(mgr.view() | bstk::where_root_access()) == names_of(mgr.with_root_access()));
+		CHECK(names(mgr.view() | bstk::where_high_fps()) == names_of(mgr.with_high_fps()));
+		CHECK(names(mgr.view() | bstk::where_resolution(1920, 1080)) == names_of(mgr.matching_resolution(1920, 1080)));
+		CHECK(names(mgr.view() | bstk::where_ram_at_least(4096)) == expected([](const Properties& p) { return p.ram >= 4096; }));
+		CHECK(names(mgr.view() | bstk::where_cpus_at_least(3)) == expected([](const Properties& p) { return p.cpus >= 3; }));
+		CHECK(!names(mgr.view() | bstk::where_root_access()).empty());
+
+		// Composed adaptors, std::views and a const manager
+		const bstk::InstanceManager& cmgr = mgr;
+		auto both = expected([](const Properties& p) { return p.enable_high_fps && p.ram >= 3072; });
+		CHECK(!both.empty());
+		CHECK(names(cmgr.view() | bstk::where_high_fps() | bstk::where_ram_at_least(3072)) == both);
+		std::vector<int> rams;
+		for (int ram : mgr.view() | bstk::where_high_fps() | bstk::where_ram_at_least(3072)
+			| std::views::transform([](const bstk::Instance& inst) { return inst.props().ram; })) {
+			rams.push_back(ram);
+		}
+		CHECK(rams.size() == both.size());
+		CHECK(std::ranges::all_of(rams, [](int ram) { return ram >= 3072; }));
+
+		// find_all and find take the same predicates without std::function
+		auto root = [](const bstk::Instance& inst) { return inst.props().enable_root_access; };
+		CHECK(names_of(mgr.find_all(root)) == names_of(mgr.with_root_access()));
+		CHECK(mgr.find(root) == &mgr[0]);
+		CHECK(mgr.find([](const bstk::Instance& inst) { return inst.props().ram > 1 << 20; }) == nullptr);
+		CHECK(mgr.find_all([](const bstk::Instance&) { return false; }).empty());
+
+		// Views evaluate on iteration: the predicate runs once per instance
+		// per pass and later changes are seen
+		int calls = 0;
+		auto counted = mgr.view() | bstk::where([&calls](const bstk::Instance& inst) {
+			++calls;
+			return inst.props().cpus == 4;
+		});
+		CHECK(calls == 0);
+		CHECK(names(counted).size() == 3);
+		CHECK(calls == 12);
+		mgr[0].performance(4, 1024);
+		CHECK(names(mgr.view() | bstk::where_cpus_at_least(4)).size() == 4);
+		mgr.remove("Pie64_3");
+		CHECK(names(mgr.view() | bstk::where_cpus_at_least(4)).size() == 3);
+	}
+
+	void mapped_file_reads_regular_files() {
+		auto path = std::filesystem::temp_directory_path() / "bstk_tests_mapped.conf";
+		{
+			std::ofstream out(path, std::ios::binary | std::ios::trunc);
+			out << "bst.a=\"1\"\n";
+		}
+
+		bstk::MappedFile file(path.string());
+		CHECK(file.is_open());
+		CHECK(file.view() == "bst.a=\"1\"\n");
+
+		// The view must follow the move
+		bstk::MappedFile moved(std::move(file));
+		CHECK(!file.is_open());
+		CHECK(moved.view() == "bst.a=\"1\"\n");
+
+		std::filesystem::remove(path);
+		CHECK(!bstk::MappedFile(path.string()).is_open());
+	}
+
+	void save_patch_skips_same_text() {
+		auto path = std::filesystem::temp_directory_path() / "bstk_tests_patch.conf";
+		{
+			std::ofstream out(path, std::ios::binary | std::ios::trunc);
+			out << "bst.a=\"1\"\r\n# kept\r\nbst.s=\"x\"\r\nbst.port=\"5555\"\r\nbst.d=\"1.0\"\r\n";
+		}
+
+		bstk::Config config;
+		CHECK(config.load_from_file(path.string()));
+		// The file's "1" parses as a Bool, the same text as an Int is no change
+		config.set_int("bst.a", 1);
+		CHECK(config.dirty_keys().empty());
+		CHECK(!bstk::Value(int64_t{ 1 }).same_text(bstk::Value(int64_t{ 2 })));
+		CHECK(bstk::Value(true).same_text(bstk::Value(std::string_view("1"))));
+		CHECK(std::get<int64_t>(config.get("bst.a")->to_variant()) == 1);
+
+		// The caller's kind is stored even when the text matches
+		config.set_string("bst.port", "5555");
+		CHECK(config.get("bst.port")->is_string());
+		config.set_string("bst.d", "1.0");
+		CHECK(config.get("bst.d")->is_string());
+		CHECK(config.dirty_keys().empty());
+
+		config.set_string("bst.s", "y");
+		CHECK(config.save_patch(path.string()));
+		CHECK(config.dirty_keys().empty());
+
+		std::ifstream in(path, std::ios::binary);
+		std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		CHECK(text == "bst.a=\"1\"\r\n# kept\r\nbst.s=\"y\"\r\nbst.port=\"5555\"\r\nbst.d=\"1.0\"\r\n");
+		in.close();
+		std::filesystem::remove(path);
+	}
+
+	void cache_hit_keeps_order_and_index() {
+		auto path = std::filesystem::temp_directory_path() / "bstk_tests_cached.conf";
+		auto cache = path.string() + ".cache";
+		{
+			std::ofstream out(path, std::ios::binary | std::ios::trunc);
+			out << "bst.z=\"1\"\nbst.b=\"x\"\nother=\"2.5\"\nbst.a=\"0\"\n";
+		}
+		std::filesystem::remove(cache);
+
+		bstk::Config parsed;
+		CHECK(parsed.load_cached(path.string()));
+		CHECK(std::filesystem::exists(cache));
+
+		bstk::Config cached;
+		CHECK(cached.load_cached(path.string()));
+		CHECK(cached.to_string(bstk::SerializeOrder::Insertion) == parsed.to_string(bstk::SerializeOrder::Insertion));
+		CHECK((cached.get_keys_with_prefix("bst.") == std::vector<std::string>{ "bst.a", "bst.b", "bst.z" }));
+
+		// The index taken from the cache is maintained like a built one
+		cached.set_int("bst.m", 3);
+		CHECK((cached.get_keys_with_prefix("bst.") == std::vector<std::string>{ "bst.a", "bst.b", "bst.m", "bst.z" }));
+
+		std::filesystem::remove(path);
+		std::filesystem::remove(cache);
+	}
+
+	void parallel_load_matches_serial() {
+		// Large enough for several chunks, with keys repeated across them
+		std::string content;
+		for (int i = 0; i < 40000; ++i) {
+			int key = i % 25000;
+			content += "bst.instance.Pie64_" + std::to_string(key % 7) + ".key_" + std::to_string(key) + "=\"" + std::to_string(i) + "\"\n";
+		}
+
+		bstk::Config serial;
+		bstk::Config parallel;
+		CHECK(serial.load_from_string(content));
+		CHECK(parallel.load_from_string_parallel(content, 4));
+		CHECK(parallel.size() == 25000);
+		CHECK(parallel.to_string(bstk::SerializeOrder::Insertion) == serial.to_string(bstk::SerializeOrder::Insertion));
+	}
+
+	void config_set_loads_on_pool() {
+		auto dir = std::filesystem::temp_directory_path() / "bstk_tests_set";
+		std::filesystem::create_directories(dir);
+		std::vector<std::string> paths;
+		for (int i = 0; i < 9; ++i) {
+			auto path = dir / ("host" + std::to_string(i) + ".conf");
+			std::ofstream(path, std::ios::binary | std::ios::trunc) << "bst.instance.Pie64.ram=\"" << (i % 2 ? 4096 : 2048) << "\"\n";
+			paths.push_back(path.string());
+		}
+		paths.push_back((dir / "missing.conf").string());
+
+		bstk::ConfigSet set;
+		auto stats = set.load(paths, 4);
+		CHECK(stats.loaded == 9);
+		CHECK(stats.failed == 1);
+		auto counts = set.distribution("bst.instance.*.ram");
+		CHECK(counts["2048"] == 5);
+		CHECK(counts["4096"] == 4);
+
+		// The failure says why, not just that it failed
+		const auto* missing = set.find(paths.back());
+		CHECK(missing && !missing->loaded);
+		CHECK(missing && missing->error == "cannot open file: " + std::make_error_code(std::errc::no_such_file_or_directory).message());
+
+		std::filesystem::remove_all(dir);
+	}
+
+	void config_set_reports_traversal_errors() {
+		auto dir = std::filesystem::temp_directory_path() / "bstk_tests_walk";
+		std::filesystem::remove_all(dir);
+		std::filesystem::create_directories(dir / "a");
+		std::ofstream(dir / "a" / "bluestacks.conf", std::ios::binary | std::ios::trunc) << "bst.a=\"1\"\n";
+
+		bstk::ConfigSet set;
+		auto stats = set.load_directory(dir.string());
+		CHECK(stats.loaded == 1);
+		CHECK(stats.error.empty());
+
+		// A root that cannot be walked is reported with its path
+		auto missing = (dir / "missing").string();
+		stats = set.load_directory(missing);
+		CHECK(stats.loaded == 0);
+		CHECK(stats.error.starts_with(missing + ": "));
+
+#ifndef _WIN32
+		// A dangling link with the right name is a failed member, not skipped
+		std::filesystem::create_directories(dir / "b");
+		std::filesystem::create_symlink(dir / "nowhere", dir / "b" / "bluestacks.conf");
+		stats = set.load_directory(dir.string());
+		CHECK(stats.loaded == 1);
+		CHECK(stats.failed == 1);
+		CHECK(set.failed().size() == 1 && set.failed()[0]->error.starts_with("cannot open file: "));
+#endif
+
+		std::filesystem::remove_all(dir);
+	}
+
+	void namespace_bounds_without_joined_prefix() {
+		bstk::Config config;
+		for (const char* key : { "bst-x", "bst", "bst.a", "bst_y", "bst.b.c", "bsta", "bs" }) {
+			config.set_int(key, 1);
+		}
+
+		// "bst" and "bst." both mean the keys under "bst.", whatever sorts around them
+		bstk::Config ns = config.get_namespace("bst");
+		CHECK(ns.size() == 2);
+		CHECK(ns.get("a") && ns.get("b.c"));
+		CHECK(config.get_namespace("bst.").size() == 2);
+		CHECK((config.get_keys_with_prefix("bst") == std::vector<std::string>{ "bst", "bst-x", "bst.a", "bst.b.c", "bst_y", "bsta" }));
+		CHECK(config.view("bst").size() == 2);
+		CHECK(config.get_namespace("nope").empty());
+	}
+
+#ifndef _WIN32
+	void mapped_file_reads_pipes() {
+		CHECK(bstk::MappedFile("/dev/null").is_open());
+#ifdef __linux__
+		// procfs reports a size of 0 but has content
+		CHECK(bstk::MappedFile("/proc/self/status").view().starts_with("Name:"));
+#endif
+
+		auto path = std::filesystem::temp_directory_path() / "bstk_tests_fifo";
+		std::filesystem::remove(path);
+		CHECK(::mkfifo(path.c_str(), 0600) == 0);
+		std::thread writer([&] {
+			std::ofstream out(path);
+			out << "bst.a=\"1\"\nbst.b=\"2\"\n";
+		});
+
+		bstk::Config config;
+		CHECK(config.load_from_file(path.string()));
+		writer.join();
+		CHECK(config.size() == 2);
+		CHECK(config.get_or<int>("bst.b", 0) == 2);
+		std::filesystem::remove(path);
+	}
+#endif
+
+} // namespace
+
+int main() {
+	lookups_do_not_allocate();
+	resolve_grows_free_list_geometrically();
+	handle_stale_after_copy_assign();
+	handle_stale_after_move_assign();
+	handle_stale_after_clear();
+	subscriptions_survive_assignment();
+	throwing_callback_in_batch_is_contained();
+	batch_survives_assignment();
+	rollback_across_reload();
+	batch_guard_rolls_back_on_unwind();
+	shared_config_reader_follows_version();
+	concurrent_prefix_queries();
+	tokenizer_kernels_match_split_line();
+	extreme_doubles_round_trip();
+	lazy_values_match_eager();
+	stream_parser_ignores_chunk_boundaries();
+	instance_round_trips_every_field();
+	instance_table_tracks_add_and_remove();
+	instance_views_filter_lazily();
+	mapped_file_reads_regular_files();
+	save_patch_skips_same_text();
+	cache_hit_keeps_order_and_index();
+	parallel_load_matches_serial();
+	config_set_loads_on_pool();
+	config_set_reports_traversal_errors();
+	namespace_bounds_without_joined_prefix();
+#ifndef _WIN32
+	mapped_file_reads_pipes();
+#endif
+
+	if (failures) {
+		std::cerr << failures << " check(s) failed\n";
+		return 1;
+	}
+	std::cout << "All tests passed\n";
+	return 0;
+}
\ No newline at end of file